@@ -5,6 +5,10 @@
 #include "range2.h"
 #endif
 
+#ifndef INCLUDED_CONTIGUOUS
+#include "contiguous.h"
+#endif
+
 #ifndef INCLUDED_CASSERT
 #define INCLUDED_CASSERT
 #include <cassert>
@@ -113,10 +117,11 @@ ALWAYS_INLINE_HIDDEN equivalent<Op> make_equivalent(Op op) {
   return {cmove(op)};
 }
 
+namespace impl {
+
 template<typename Range, typename Op>
-// Requires input_type(Op, 0) == RangeIterator(Range)
 INLINE pair<Op, Range>
-for_each_impl(Range r, Op op) {
+for_each_loop(Range r, Op op) {
   while (!is_empty(r)) {
     op(get_begin(r));
     r = successor(r);
@@ -124,38 +129,219 @@ for_each_impl(Range r, Op op) {
   return range2::make_pair(op, r);
 }
 
+template<int N>
+struct TYPE_HIDDEN_VISIBILITY unrolled_steps
+{
+  template<typename Iterator, typename Op>
+  static ALWAYS_INLINE_HIDDEN Iterator apply(Iterator i, Op& op) {
+    op(i);
+    return unrolled_steps<N - 1>::apply(successor(i), op);
+  }
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY unrolled_steps<0>
+{
+  template<typename Iterator, typename Op>
+  static ALWAYS_INLINE_HIDDEN Iterator apply(Iterator i, Op&) {
+    return i;
+  }
+};
+
+// Tests the count once per N applications of op rather than the range for emptiness once per
+// application, then finishes the remainder one at a time.
+template<int N, typename Range, typename Op>
+// Requires IsACountedRange<Range>
+INLINE pair<Op, Range>
+for_each_unrolled(Range r, Op op) {
+  auto i = get_begin(r);
+  auto n = get_count(r);
+  for (; n >= N; n -= N) i = unrolled_steps<N>::apply(cmove(i), op);
+  for (; n != 0; --n) i = unrolled_steps<1>::apply(cmove(i), op);
+  return range2::make_pair(op, Range::make(cmove(i), get_end(r), n));
+}
+
+template<typename Range, typename Op>
+ALWAYS_INLINE_HIDDEN pair<Op, Range> for_each_select(Range r, Op op, std::false_type) {
+  return for_each_loop(r, op);
+}
+
+// Unrolled by 4: at -Os GCC stops inlining a caller's op once 8 copies of it are needed, and
+// the calls make such a loop several times slower than the plain loop.
+template<typename Range, typename Op>
+ALWAYS_INLINE_HIDDEN pair<Op, Range> for_each_select(Range r, Op op, std::true_type) {
+  return for_each_unrolled<4>(r, op);
+}
+
+} // namespace impl
+
+template<typename Range, typename Op>
+// Requires input_type(Op, 0) == RangeIterator(Range)
+ALWAYS_INLINE_HIDDEN pair<Op, Range>
+for_each_impl(Range r, Op op) {
+  return impl::for_each_select(r, op, IsInlineable<Range>{});
+}
+
+namespace impl {
+
+// Each entry point lowers contiguous ranges to pointers, so the loops, and any overloads for
+// pointers, see raw memory, then lifts the ranges returned back to the caller's iterators.
+template<typename Range, typename Op>
+ALWAYS_INLINE_HIDDEN auto for_each_lowered(Range r, Op op, std::false_type) -> decltype( for_each_impl(r, op) ) {
+  return for_each_impl(r, op);
+}
+
+template<typename Range, typename Op>
+ALWAYS_INLINE_HIDDEN pair<Op, Range> for_each_lowered(Range r, Op op, std::true_type) {
+  auto tmp = for_each_impl(lower(r), op);
+  return range2::make_pair(cmove(tmp.m0), lift_range<Range>::apply(get_begin(r), tmp.m1));
+}
+
+} // namespace impl
+
 template<typename Range, typename Op>
 // Requires input_type(Op, 0) == RangeIterator(Range)
 ALWAYS_INLINE_HIDDEN auto for_each(Range r, Op op) -> decltype( for_each_impl(add_constant_time_count(r), op) ) {
   static_assert(IsAFiniteRange<Range>::value, "Must be a finite range");
 
-  return for_each_impl(add_constant_time_count(r), op);
+  return impl::for_each_lowered(add_constant_time_count(r), op, impl::CanLower<Op, decltype(add_constant_time_count(r))>{});
 }
 
 
+namespace impl {
+
 template<typename Range, typename Pred>
 INLINE Range
-find_if_impl(Range r, Pred p) {
+find_if_loop(Range r, Pred p) {
   while (!is_empty(r) && !p(get_begin(r))) r = successor(r);
   return r;
 }
 
+template<typename Range, typename Pred>
+// Requires IsACountedRange<Range>
+INLINE Range
+find_if_unrolled(Range r, Pred p) {
+  auto i = get_begin(r);
+  auto n = get_count(r);
+  for (; n >= 4; n -= 4) {
+    if (p(i)) return Range::make(cmove(i), get_end(r), n);
+    auto i1 = successor(i);
+    if (p(i1)) return Range::make(cmove(i1), get_end(r), n - 1);
+    auto i2 = successor(i1);
+    if (p(i2)) return Range::make(cmove(i2), get_end(r), n - 2);
+    auto i3 = successor(i2);
+    if (p(i3)) return Range::make(cmove(i3), get_end(r), n - 3);
+    i = successor(i3);
+  }
+  for (; n != 0 && !p(i); --n) i = successor(i);
+  return Range::make(cmove(i), get_end(r), n);
+}
+
+template<typename Range, typename Pred>
+ALWAYS_INLINE_HIDDEN Range find_if_select(Range r, Pred p, std::false_type) {
+  return find_if_loop(r, p);
+}
+
+template<typename Range, typename Pred>
+ALWAYS_INLINE_HIDDEN Range find_if_select(Range r, Pred p, std::true_type) {
+  return find_if_unrolled(r, p);
+}
+
+} // namespace impl
+
+template<typename Range, typename Pred>
+ALWAYS_INLINE_HIDDEN Range
+find_if_impl(Range r, Pred p) {
+  return impl::find_if_select(r, p, IsInlineable<Range>{});
+}
+
+namespace impl {
+
+template<typename Range, typename Pred>
+ALWAYS_INLINE_HIDDEN auto find_if_lowered(Range r, Pred p, std::false_type) -> decltype( find_if_impl(r, p) ) {
+  return find_if_impl(r, p);
+}
+
+template<typename Range, typename Pred>
+ALWAYS_INLINE_HIDDEN Range find_if_lowered(Range r, Pred p, std::true_type) {
+  return lift_range<Range>::apply(get_begin(r), find_if_impl(lower(r), p));
+}
+
+} // namespace impl
+
 template<typename Range, typename Pred>
 ALWAYS_INLINE_HIDDEN auto find_if(Range r, Pred p) -> decltype ( find_if_impl(add_constant_time_count(r), p) ) {
-  return find_if_impl(add_constant_time_count(r), p);
+  return impl::find_if_lowered(add_constant_time_count(r), p, impl::CanLower<Pred, decltype(add_constant_time_count(r))>{});
 }
 
 
 
+namespace impl {
+
 template<typename Range, typename Pred, typename CountType>
-ALWAYS_INLINE_HIDDEN CountType count_if_impl(Range r, Pred p, CountType c) {
-  for_each_impl(r, [&p, &c](RangeIterator<Range> const& x) -> void { if (p(x)) c = c + 1; });
+ALWAYS_INLINE_HIDDEN CountType count_if_loop(Range r, Pred p, CountType c) {
+  for_each_loop(r, [&p, &c](RangeIterator<Range> const& x) -> void { if (p(x)) c = c + 1; });
   return c;
 }
 
+// Alternate elements are counted separately so neither count waits on the other.
+template<typename Range, typename Pred, typename CountType>
+// Requires IsACountedRange<Range>
+INLINE CountType count_if_unrolled(Range r, Pred p, CountType c) {
+  CountType c1 = c - c;
+  auto i = get_begin(r);
+  auto n = get_count(r);
+  for (; n >= 4; n -= 4) {
+    auto i1 = successor(i);
+    auto i2 = successor(i1);
+    auto i3 = successor(i2);
+    if (p(i)) c = c + 1;
+    if (p(i1)) c1 = c1 + 1;
+    if (p(i2)) c = c + 1;
+    if (p(i3)) c1 = c1 + 1;
+    i = successor(i3);
+  }
+  for (; n != 0; --n) {
+    if (p(i)) c = c + 1;
+    i = successor(i);
+  }
+  return c + c1;
+}
+
+template<typename Range, typename Pred, typename CountType>
+ALWAYS_INLINE_HIDDEN CountType count_if_select(Range r, Pred p, CountType c, std::false_type) {
+  return count_if_loop(r, p, c);
+}
+
+template<typename Range, typename Pred, typename CountType>
+ALWAYS_INLINE_HIDDEN CountType count_if_select(Range r, Pred p, CountType c, std::true_type) {
+  return count_if_unrolled(r, p, c);
+}
+
+} // namespace impl
+
+template<typename Range, typename Pred, typename CountType>
+ALWAYS_INLINE_HIDDEN CountType count_if_impl(Range r, Pred p, CountType c) {
+  return impl::count_if_select(r, p, c, IsInlineable<Range>{});
+}
+
+namespace impl {
+
+template<typename Range, typename Pred, typename CountType>
+ALWAYS_INLINE_HIDDEN CountType count_if_lowered(Range r, Pred p, CountType c, std::false_type) {
+  return count_if_impl(r, p, c);
+}
+
+template<typename Range, typename Pred, typename CountType>
+ALWAYS_INLINE_HIDDEN CountType count_if_lowered(Range r, Pred p, CountType c, std::true_type) {
+  return count_if_impl(lower(r), p, c);
+}
+
+} // namespace impl
+
 template<typename Range, typename Pred, typename CountType>
 ALWAYS_INLINE_HIDDEN CountType count_if(Range r, Pred p, CountType c) {
-  return count_if_impl(add_constant_time_count(r), p, c);
+  return impl::count_if_lowered(add_constant_time_count(r), p, c, impl::CanLower<Pred, decltype(add_constant_time_count(r))>{});
 }
 
 
@@ -179,17 +365,85 @@ ALWAYS_INLINE_HIDDEN reduce_op<Op, Func, State> make_reduce_op(Op op, Func func,
 }
 
 
+namespace impl {
+
+template<typename Range, typename Op, typename Func>
+ALWAYS_INLINE_HIDDEN pair<RangeValue<Range>, Range> reduce_nonempty_loop(Range r, Op op, Func f) {
+  auto tmp = for_each_loop(successor(r), make_reduce_op(op, f, deref(get_begin(r))));
+  return range2::make_pair(cmove(tmp.m0.state), cmove(tmp.m1));
+}
+
+// Each group of four is reduced as two independent pairs before joining the running state, so
+// only one op per group waits on the previous group. As op is associative the result is unchanged.
+template<typename Range, typename Op, typename Func>
+// Requires IsACountedRange<Range>
+INLINE pair<RangeValue<Range>, Range> reduce_nonempty_unrolled(Range r, Op op, Func f) {
+  auto i = get_begin(r);
+  auto n = get_count(r) - 1;
+  RangeValue<Range> state = deref(i);
+  i = successor(i);
+  for (; n >= 4; n -= 4) {
+    auto i1 = successor(i);
+    auto i2 = successor(i1);
+    auto i3 = successor(i2);
+    state = op(state, op(op(f(i), f(i1)), op(f(i2), f(i3))));
+    i = successor(i3);
+  }
+  for (; n != 0; --n) {
+    state = op(state, f(i));
+    i = successor(i);
+  }
+  return range2::make_pair(cmove(state), Range::make(cmove(i), get_end(r), n));
+}
+
+template<typename Range, typename Op, typename Func>
+ALWAYS_INLINE_HIDDEN pair<RangeValue<Range>, Range> reduce_nonempty_select(Range r, Op op, Func f, std::false_type) {
+  return reduce_nonempty_loop(r, op, f);
+}
+
+template<typename Range, typename Op, typename Func>
+ALWAYS_INLINE_HIDDEN pair<RangeValue<Range>, Range> reduce_nonempty_select(Range r, Op op, Func f, std::true_type) {
+  return reduce_nonempty_unrolled(r, op, f);
+}
+
+} // namespace impl
+
 template<typename Range, typename Op, typename Func>
 ALWAYS_INLINE_HIDDEN pair<RangeValue<Range>, Range> reduce_nonempty_impl(Range r, Op op, Func f) {
   assert(!is_empty(r));
-  auto tmp = for_each_impl(successor(r), make_reduce_op(op, f, deref(get_begin(r))));
-  return range2::make_pair(cmove(tmp.m0.state), cmove(tmp.m1));
+  return impl::reduce_nonempty_select(r, op, f, IsInlineable<Range>{});
 }
 
+namespace impl {
+
+template<typename Range, typename Op, typename Func>
+ALWAYS_INLINE_HIDDEN auto reduce_nonempty_lowered(Range r, Op op, Func f, std::false_type) -> decltype( reduce_nonempty_impl(r, op, f) ) {
+  return reduce_nonempty_impl(r, op, f);
+}
+
+template<typename Range, typename Op, typename Func>
+ALWAYS_INLINE_HIDDEN pair<RangeValue<Range>, Range> reduce_nonempty_lowered(Range r, Op op, Func f, std::true_type) {
+  auto tmp = reduce_nonempty_impl(lower(r), op, f);
+  return range2::make_pair(cmove(tmp.m0), lift_range<Range>::apply(get_begin(r), tmp.m1));
+}
+
+template<typename Range, typename Op, typename Func>
+ALWAYS_INLINE_HIDDEN auto reduce_lowered(Range r, Op op, Func f, RangeValue<Range> const& z, std::false_type) -> decltype( reduce_impl(r, op, f, z) ) {
+  return reduce_impl(r, op, f, z);
+}
+
+template<typename Range, typename Op, typename Func>
+ALWAYS_INLINE_HIDDEN pair<RangeValue<Range>, Range> reduce_lowered(Range r, Op op, Func f, RangeValue<Range> const& z, std::true_type) {
+  auto tmp = reduce_impl(lower(r), op, f, z);
+  return range2::make_pair(cmove(tmp.m0), lift_range<Range>::apply(get_begin(r), tmp.m1));
+}
+
+} // namespace impl
+
 template<typename Range, typename Op, typename Func>
 ALWAYS_INLINE_HIDDEN auto reduce_nonempty(Range r, Op op, Func f) -> decltype( reduce_nonempty_impl(add_constant_time_count(r), op, f) ) {
   assert(!is_empty(r));
-  return reduce_nonempty_impl(add_constant_time_count(r), op, f);
+  return impl::reduce_nonempty_lowered(add_constant_time_count(r), op, f, impl::CanLower<Func, decltype(add_constant_time_count(r))>{});
 }
 
 
@@ -201,7 +455,7 @@ ALWAYS_INLINE_HIDDEN pair<RangeValue<Range>, Range> reduce_impl(Range r, Op op,
 
 template<typename Range, typename Op, typename Func>
 ALWAYS_INLINE_HIDDEN auto reduce(Range r, Op op, Func f, RangeValue<Range> const& z) -> decltype( reduce_impl(add_constant_time_count(r), op, f, z) ) {
-  return reduce_impl(add_constant_time_count(r), op, f, z);
+  return impl::reduce_lowered(add_constant_time_count(r), op, f, z, impl::CanLower<Func, decltype(add_constant_time_count(r))>{});
 }
 
 template<typename Op, typename Func, typename State>
@@ -270,6 +524,96 @@ ALWAYS_INLINE_HIDDEN auto find_mismatch(Range0 r0, Range1 r1, Rel rel) -> declty
   return find_mismatch_impl(add_constant_time_count(r0), add_constant_time_count(r1), rel);
 }
 
+struct TYPE_HIDDEN_VISIBILITY Find_Mismatch { typedef Find_Mismatch type; };
+
+// Counts are only used where free, so no setup pass.
+template<typename Range0, typename Range1>
+struct TYPE_HIDDEN_VISIBILITY Complexity<Find_Mismatch, Range0, Range1> : CostPlan<ConstantComplexity, LinearComplexity> {};
+
+
+template<typename Range0, typename Range1, typename Rel>
+// Requires IsACountedRange<Range0> && IsACountedRange<Range1> && RepeatableRange<Range0>
+INLINE pair<Range<RangeIterator<Range0>, Present, Present>, Range0>
+search_impl(Range0 r0, Range1 r1, Rel rel) {
+  auto m = get_count(r1);
+  while (get_count(r0) >= m) {
+    auto tmp = find_mismatch_impl(make_range(get_begin(r0), NotPresent{}, m), r1, rel);
+    if (is_empty(tmp.m1)) {
+      return range2::make_pair(make_range(get_begin(r0), get_begin(tmp.m0), m),
+                               make_range(get_begin(tmp.m0), get_end(r0), get_count(r0) - m));
+    }
+    r0 = successor(r0);
+  }
+  auto last = range2::advance(get_begin(r0), get_count(r0));
+  return range2::make_pair(make_range(last, last, m - m), make_range(last, get_end(r0), m - m));
+}
+
+template<typename Range0, typename Range1, typename Rel>
+// Requires IsACountedRange<Range1> && RepeatableRange<Range0> && IsAFiniteRange<Range0>
+INLINE pair<Range<RangeIterator<Range0>, Present, Present>, Range0>
+search_uncounted_impl(Range0 r0, Range1 r1, Rel rel) {
+  auto m = get_count(r1);
+  while (true) {
+    auto tmp = find_mismatch_impl(r0, r1, rel);
+    if (is_empty(tmp.m1)) {
+      return range2::make_pair(make_range(get_begin(r0), get_begin(tmp.m0), m), tmp.m0);
+    }
+    if (is_empty(tmp.m0)) {
+      // Fewer than m elements remain, so no later position can match either.
+      return range2::make_pair(make_range(get_begin(tmp.m0), get_begin(tmp.m0), m - m), tmp.m0);
+    }
+    r0 = successor(r0);
+  }
+}
+
+namespace impl {
+
+template<typename Range0, typename Range1, typename Rel>
+ALWAYS_INLINE_HIDDEN auto search_lowered(Range0 r0, Range1 r1, Rel rel, std::false_type) -> decltype( search_impl(r0, r1, rel) ) {
+  return search_impl(r0, r1, rel);
+}
+
+template<typename Range0, typename Range1, typename Rel>
+ALWAYS_INLINE_HIDDEN pair<Range<RangeIterator<Range0>, Present, Present>, Range0> search_lowered(Range0 r0, Range1 r1, Rel rel, std::true_type) {
+  auto tmp = search_impl(lower(r0), lower(r1), rel);
+  return range2::make_pair(lift_range<Range<RangeIterator<Range0>, Present, Present>>::apply(get_begin(r0), tmp.m0),
+                           lift_range<Range0>::apply(get_begin(r0), tmp.m1));
+}
+
+template<typename Range0, typename Range1, typename Rel>
+ALWAYS_INLINE_HIDDEN auto search_strategy(Range0 r0, Range1 r1, Rel rel, ConstantComplexity) -> decltype( search_impl(add_constant_time_count(r0), r1, rel) ) {
+  return search_lowered(add_constant_time_count(r0), r1, rel, CanLower<Rel, decltype(add_constant_time_count(r0)), Range1>{});
+}
+
+// Counting r0 up front would be a pass of its own, so run off its end instead.
+template<typename Range0, typename Range1, typename Rel>
+ALWAYS_INLINE_HIDDEN auto search_strategy(Range0 r0, Range1 r1, Rel rel, LinearComplexity) -> decltype( search_uncounted_impl(r0, r1, rel) ) {
+  return search_uncounted_impl(r0, r1, rel);
+}
+
+} // namespace impl
+
+// Returns the first sub-range of r0 matching r1 under rel, or an empty range at the end of r0,
+// and the remainder of r0 following it.
+template<typename Range0, typename Range1, typename Rel>
+ALWAYS_INLINE_HIDDEN auto search(Range0 r0, Range1 r1, Rel rel)
+  -> decltype( impl::search_strategy(r0, add_linear_time_count(r1), rel, typename Complexity<AddCount, Range0, void>::type{}) ) {
+  static_assert(RepeatableRange<Range0>::value, "Search restarts from each position so must be a forward range");
+  return impl::search_strategy(r0, add_linear_time_count(r1), rel, typename Complexity<AddCount, Range0, void>::type{});
+}
+
+struct TYPE_HIDDEN_VISIBILITY Search { typedef Search type; };
+
+// Setup counts the needle; the traversal is linear in the haystack for a given needle.
+template<typename Range0, typename Range1>
+struct TYPE_HIDDEN_VISIBILITY Complexity<Search, Range0, Range1> : CostPlan<Complexity<AddCount, Range1, void>, LinearComplexity> {};
+
+template<typename Range0, typename Range1>
+ALWAYS_INLINE_HIDDEN auto search(Range0 r0, Range1 r1) -> decltype( search(r0, r1, make_derefop(std::equal_to<RangeValue<Range0>>{})) ) {
+  static_assert(std::is_same<RangeValue<Range0>, RangeValue<Range1>>::value, "Both ranges must have the same value type");
+  return search(r0, r1, make_derefop(std::equal_to<RangeValue<Range0>>{}));
+}
+
 
 template<typename Range, typename Rel>
 INLINE pair<RangeValue<Range>, Range> find_adjacent_mismatch_input_non_empty_impl(Range r, Rel rel) {
@@ -390,12 +734,67 @@ ALWAYS_INLINE_HIDDEN auto partition_point_impl(Range r, Pred pred) -> decltype(
   return bisecting_search<Range, 0>(r, pred, impl::Halve{});
 }
 
+// Counting r first would be a pass over all of it, so instead probes 1, 2, 4, ... elements
+// ahead until pred holds and then bisects the last span. Makes O(log p) applications of pred
+// and O(p) successors, p being the number of elements before the partition point; as the
+// elements after it are not visited the remainder is returned without a count.
+template<typename Rng, typename Pred>
+// Requires RepeatableRange<Rng> && IsAFiniteRange<Rng>
+INLINE pair<Range<RangeIterator<Rng>, Present, Present>, Rng>
+partition_point_uncounted_impl(Rng r, Pred pred) {
+  typedef RangeDifferenceType<Rng> D;
+  auto rest = r;
+  D lhsN = 0;
+  for (D step = 1; !is_empty(rest); step = step + step) {
+    // probe stops step - 1 elements on, or at the last element
+    auto probe = rest;
+    D k = 0;
+    while (k + 1 != step) {
+      auto next = successor(probe);
+      if (is_empty(next)) break;
+      probe = next, ++k;
+    }
+    if (pred(get_begin(probe))) {
+      auto span = make_range(get_begin(rest), NotPresent{}, k);
+      auto tmp = bisecting_search<decltype(span), 0>(span, pred, impl::Halve{});
+      lhsN = lhsN + get_count(tmp.m0);
+      return range2::make_pair(make_range(get_begin(r), get_begin(tmp.m1), lhsN), make_range(get_begin(tmp.m1), get_end(r), NotPresent{}));
+    }
+    lhsN = lhsN + k + 1;
+    rest = successor(probe);
+  }
+  return range2::make_pair(make_range(get_begin(r), get_begin(rest), lhsN), rest);
+}
+
+namespace impl {
+
 template<typename Range, typename Pred>
-ALWAYS_INLINE_HIDDEN auto partition_point(Range r, Pred pred) -> decltype( partition_point_impl(add_linear_time_count(r), pred) ) {
+ALWAYS_INLINE_HIDDEN auto partition_point_strategy(Range r, Pred pred, ConstantComplexity) -> decltype( partition_point_impl(add_constant_time_count(r), pred) ) {
+  return partition_point_impl(add_constant_time_count(r), pred);
+}
+
+template<typename Range, typename Pred>
+ALWAYS_INLINE_HIDDEN auto partition_point_strategy(Range r, Pred pred, LinearComplexity) -> decltype( partition_point_uncounted_impl(r, pred) ) {
+  return partition_point_uncounted_impl(r, pred);
+}
+
+} // namespace impl
+
+// Bisects r where its count is free; otherwise, as for a bounded forward_list range, searches
+// forward without counting r.
+template<typename Range, typename Pred>
+ALWAYS_INLINE_HIDDEN auto partition_point(Range r, Pred pred) -> decltype( impl::partition_point_strategy(r, pred, typename Complexity<AddCount, Range, void>::type{}) ) {
   static_assert(IsAFiniteRange<Range>::value, "Must be a finite range to perform binary search");
-  return partition_point_impl(add_linear_time_count(r), pred);
+  return impl::partition_point_strategy(r, pred, typename Complexity<AddCount, Range, void>::type{});
 }
 
+struct TYPE_HIDDEN_VISIBILITY Partition_Point { typedef Partition_Point type; };
+
+// Neither strategy counts the range first, so there is no setup; the traversal is logarithmic
+// only where iterators advance in constant time.
+template<typename Range>
+struct TYPE_HIDDEN_VISIBILITY Complexity<Partition_Point, Range> : CostPlan<ConstantComplexity, if_<std::is_same<ConstantComplexity, typename Complexity<Advance, RangeIterator<Range>>::type>::value, LogarithmicComplexity, LinearComplexity>> {};
+
 namespace impl {
 
 template<typename Value, typename Rel>
@@ -439,8 +838,8 @@ template<typename Range, typename Rel>
 }
 
 template<typename Range, typename Rel>
-ALWAYS_INLINE_HIDDEN auto lower_bound_predicate(Range r, Rel rel, RangeValue<Range> const& a) -> decltype( lower_bound_predicate_impl(add_linear_time_count(r), rel, a) ) {
-  return lower_bound_predicate_impl(add_linear_time_count(r), rel, a);
+ALWAYS_INLINE_HIDDEN auto lower_bound_predicate(Range r, Rel rel, RangeValue<Range> const& a) -> decltype( partition_point(r, impl::make_lower_bound_pred(&a, rel)) ) {
+  return partition_point(r, impl::make_lower_bound_pred(&a, rel));
 }
 
 
@@ -450,8 +849,8 @@ template<typename Range, typename Rel>
 }
 
 template<typename Range, typename Rel>
-ALWAYS_INLINE_HIDDEN auto upper_bound_predicate(Range r, Rel rel, RangeValue<Range> const& a) -> decltype( upper_bound_predicate_impl(add_linear_time_count(r), rel, a) ) {
-  return upper_bound_predicate_impl(add_linear_time_count(r), rel, a);
+ALWAYS_INLINE_HIDDEN auto upper_bound_predicate(Range r, Rel rel, RangeValue<Range> const& a) -> decltype( partition_point(r, impl::make_upper_bound_pred(&a, rel)) ) {
+  return partition_point(r, impl::make_upper_bound_pred(&a, rel));
 }
 
 template<typename Rng, typename Rel, typename BisectionOperation>
@@ -518,6 +917,12 @@ ALWAYS_INLINE_HIDDEN bool lexicographical_equivalent(Range0 r0, Range1 r1, Rel r
   return lexicographical_equivalent_impl(add_constant_time_count(r0), add_constant_time_count(r1), rel);
 }
 
+struct TYPE_HIDDEN_VISIBILITY Lexicographical_Equivalent { typedef Lexicographical_Equivalent type; };
+
+// Counts are compared first only where both are free.
+template<typename Range0, typename Range1>
+struct TYPE_HIDDEN_VISIBILITY Complexity<Lexicographical_Equivalent, Range0, Range1> : CostPlan<ConstantComplexity, LinearComplexity> {};
+
 
 template<typename Range0, typename Range1>
 ALWAYS_INLINE_HIDDEN bool lexicographical_equal(Range0 r0, Range1 r1) {
@@ -0,0 +1 @@
+#include "append_buffer.h"
@@ -0,0 +1,147 @@
+#ifndef INCLUDED_APPEND_BUFFER
+#define INCLUDED_APPEND_BUFFER
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+#ifndef INCLUDED_NEW
+#define INCLUDED_NEW
+#include <new>
+#endif
+
+#ifndef INCLUDED_SYS_MMAN
+#define INCLUDED_SYS_MMAN
+#include <sys/mman.h>
+#endif
+
+namespace range2 {
+
+// Contiguous buffer of trivially copyable records that only grows by appending.
+// Storage is anonymous memory mapped in multiples of the huge page size and doubled when
+// full; growth remaps the pages rather than copying the records.
+// The filled part is returned as a counted Range without copying, valid until the next append.
+template<typename T>
+class TYPE_DEFAULT_VISIBILITY append_buffer
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Records are relocated by remapping their pages");
+
+  T* first;
+  std::size_t size_;
+  std::size_t capacity_in_bytes;
+
+  INLINE void reserve_bytes(std::size_t bytes) {
+    bytes = (bytes + granule - 1) / granule * granule;
+    void* p = (0 == capacity_in_bytes)
+      ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+      : mremap(first, capacity_in_bytes, bytes, MREMAP_MAYMOVE);
+    if (MAP_FAILED == p) throw std::bad_alloc{};
+#ifdef MADV_HUGEPAGE
+    madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    first = static_cast<T*>(p);
+    capacity_in_bytes = bytes;
+  }
+
+  ALWAYS_INLINE_HIDDEN void release() {
+    if (0 != capacity_in_bytes) munmap(first, capacity_in_bytes);
+    first = nullptr, size_ = 0, capacity_in_bytes = 0;
+  }
+
+public:
+  static constexpr std::size_t granule = std::size_t(1) << 21;
+
+  explicit append_buffer(std::size_t reserve_records = 0) : first(nullptr), size_(0), capacity_in_bytes(0) {
+    if (0 != reserve_records) reserve_bytes(reserve_records * sizeof(T));
+  }
+
+  ALWAYS_INLINE_HIDDEN append_buffer(append_buffer&& x) : first(x.first), size_(x.size_), capacity_in_bytes(x.capacity_in_bytes) {
+    x.first = nullptr, x.size_ = 0, x.capacity_in_bytes = 0;
+  }
+
+  ALWAYS_INLINE_HIDDEN append_buffer& operator=(append_buffer&& x) {
+    if (this != &x) {
+      release();
+      first = x.first, size_ = x.size_, capacity_in_bytes = x.capacity_in_bytes;
+      x.first = nullptr, x.size_ = 0, x.capacity_in_bytes = 0;
+    }
+    return *this;
+  }
+
+  append_buffer(append_buffer const&) = delete;
+  append_buffer& operator=(append_buffer const&) = delete;
+
+  ALWAYS_INLINE_HIDDEN ~append_buffer() { release(); }
+
+  ALWAYS_INLINE_HIDDEN std::size_t size() const { return size_; }
+
+  ALWAYS_INLINE_HIDDEN std::size_t capacity() const { return capacity_in_bytes / sizeof(T); }
+
+  ALWAYS_INLINE_HIDDEN void clear() { size_ = 0; }
+
+  // x may refer into this buffer, which growing can move, so it is copied first.
+  ALWAYS_INLINE_HIDDEN void push_back(T const& x) {
+    if (INTROSPECTION_UNLIKELY(size_ == capacity())) {
+      T tmp = x;
+      reserve_bytes(2 * capacity_in_bytes + sizeof(T));
+      first[size_] = cmove(tmp);
+    } else {
+      first[size_] = x;
+    }
+    ++size_;
+  }
+
+  ALWAYS_INLINE_HIDDEN Range<T*, Present, Present> range() const {
+    return make_range(first, first + size_, std::ptrdiff_t(size_));
+  }
+};
+
+
+// Output iterator appending to an append_buffer; all copies share the one insertion point.
+template<typename T>
+struct TYPE_DEFAULT_VISIBILITY append_iterator_basis {
+  typedef append_buffer<T>* state_type;
+  state_type buffer;
+  typedef T value_type;
+  typedef T& reference;
+  typedef T* pointer;
+  typedef std::ptrdiff_t difference_type;
+  typedef std::output_iterator_tag iterator_category;
+
+  // The position advances as a side effect of sink.
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  append_iterator_basis successor(append_iterator_basis const& x) { return x; }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  state_type state(append_iterator_basis const& x) { return x.buffer; }
+};
+
+template<typename T>
+struct TYPE_HIDDEN_VISIBILITY AutomaticallyGenerateSink<append_iterator_basis<T>> : std::false_type {};
+
+template<typename T, typename U>
+ALWAYS_INLINE_HIDDEN void sink(append_iterator_basis<T> const& x, U&& y) {
+  static_assert(std::is_convertible<U, T>::value, "Value to sink must be convertible to value type of Iterator");
+  x.buffer->push_back(std::forward<U>(y));
+}
+
+template<typename T>
+using append_iterator = iterator<append_iterator_basis<T>>;
+
+// Unbounded output Range appending to x, e.g.
+//   visit_2_ranges(src, make_append_range(x), make_step_if(p, copy_step{}))
+// compacts the elements of src satisfying p into x in a single pass.
+template<typename T>
+ALWAYS_INLINE_HIDDEN Range<append_iterator<T>, NotPresent, NotPresent>
+make_append_range(append_buffer<T>& x) {
+  return make_range(append_iterator<T>{{&x}}, NotPresent{}, NotPresent{});
+}
+
+} // namespace range2
+
+#endif
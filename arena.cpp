@@ -0,0 +1 @@
+#include "arena.h"
@@ -0,0 +1,218 @@
+#ifndef INCLUDED_ARENA
+#define INCLUDED_ARENA
+
+#ifndef INCLUDED_COMPILER_SPECIFICS
+#include "compiler_specifics.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHM
+#define INCLUDED_ALGORITHM
+#include <algorithm>
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+#ifndef INCLUDED_CSTDINT
+#define INCLUDED_CSTDINT
+#include <cstdint>
+#endif
+
+#ifndef INCLUDED_NEW
+#define INCLUDED_NEW
+#include <new>
+#endif
+
+namespace range2 {
+
+struct TYPE_DEFAULT_VISIBILITY arena_stats
+{
+  // Bytes handed out since the last reset
+  std::size_t bytes_in_use;
+  // Largest bytes_in_use reached
+  std::size_t peak_bytes;
+  // Bytes handed out over the arena's life
+  std::size_t total_bytes;
+  // Blocks obtained from operator new
+  std::size_t upstream_allocations;
+};
+
+// Monotonic allocator for algorithm scratch memory: allocation bumps a pointer through blocks
+// obtained from operator new, nothing is freed individually, and rewind or reset makes memory
+// available again. Blocks left by rewind are kept for reuse, and reset replaces several blocks
+// by one of their total size, so a batch loop stops calling operator new after the first batch.
+// Memory is uninitialised and no destructors are run.
+class TYPE_DEFAULT_VISIBILITY arena
+{
+  struct block {
+    block* previous;
+    std::size_t size;
+  };
+
+  block* current;
+  // Blocks given up by rewind, for reuse before calling operator new
+  block* spare;
+  char* position;
+  char* end;
+  std::size_t capacity_;
+  arena_stats stats_;
+
+  static constexpr std::size_t minimum_block = 4096;
+
+  static ALWAYS_INLINE_HIDDEN char* align_up(char* p, std::size_t alignment) {
+    return reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(p) + alignment - 1) & ~std::uintptr_t(alignment - 1));
+  }
+
+  // Makes current a spare block of at least needed bytes, or else a new block of size bytes.
+  INLINE void push_block(std::size_t needed, std::size_t size) {
+    block** p = &spare;
+    while (nullptr != *p && (*p)->size < needed) p = &(*p)->previous;
+    block* b = *p;
+    if (nullptr != b) {
+      *p = b->previous;
+    } else {
+      b = static_cast<block*>(::operator new(size));
+      b->size = size;
+      capacity_ += size;
+      ++stats_.upstream_allocations;
+    }
+    b->previous = current;
+    current = b;
+    position = reinterpret_cast<char*>(b + 1);
+    end = reinterpret_cast<char*>(b) + b->size;
+  }
+
+  INLINE void pop_block() {
+    block* b = current;
+    current = b->previous;
+    b->previous = spare;
+    spare = b;
+    position = end = nullptr;
+    if (nullptr != current) end = reinterpret_cast<char*>(current) + current->size;
+  }
+
+  static INLINE void delete_blocks(block* x) {
+    while (nullptr != x) {
+      block* previous = x->previous;
+      ::operator delete(x);
+      x = previous;
+    }
+  }
+
+public:
+  // Where allocation had reached, to return to with rewind.
+  struct TYPE_DEFAULT_VISIBILITY mark_type {
+    block* b;
+    char* position;
+    std::size_t bytes_in_use;
+  };
+
+  explicit arena(std::size_t initial_bytes = 0) : current(nullptr), spare(nullptr), position(nullptr), end(nullptr), capacity_(0), stats_() {
+    if (0 != initial_bytes) push_block(initial_bytes + sizeof(block), initial_bytes + sizeof(block));
+  }
+
+  arena(arena const&) = delete;
+  arena& operator=(arena const&) = delete;
+
+  ~arena() { release(); }
+
+  // Precondition: alignment is a power of two
+  ALWAYS_INLINE_HIDDEN void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+    char* p = align_up(position, alignment);
+    // Alignment padding may take p beyond end
+    if (INTROSPECTION_UNLIKELY(nullptr == p || p > end || std::size_t(end - p) < bytes)) {
+      // A copy, as std::max taking references would odr-use minimum_block
+      std::size_t const minimum = minimum_block;
+      std::size_t const needed = bytes + alignment + sizeof(block);
+      push_block(needed, std::max(std::max(capacity_, minimum), needed));
+      p = align_up(position, alignment);
+    }
+    position = p + bytes;
+    stats_.bytes_in_use += bytes;
+    stats_.total_bytes += bytes;
+    stats_.peak_bytes = std::max(stats_.peak_bytes, stats_.bytes_in_use);
+    return p;
+  }
+
+  // Uninitialised storage for n objects of type T
+  template<typename T>
+  ALWAYS_INLINE_HIDDEN T* allocate_array(std::size_t n) {
+    return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+  }
+
+  ALWAYS_INLINE_HIDDEN mark_type mark() const {
+    return {current, position, stats_.bytes_in_use};
+  }
+
+  // Frees the allocations made since x. Blocks moved to since x are kept for later allocations.
+  INLINE void rewind(mark_type x) {
+    while (current != x.b) pop_block();
+    position = x.position;
+    stats_.bytes_in_use = x.bytes_in_use;
+  }
+
+  // Frees every allocation, keeping the memory as a single block.
+  INLINE void reset() {
+    while (nullptr != current) pop_block();
+    if (nullptr != spare && nullptr != spare->previous) {
+      std::size_t size = capacity_;
+      release();
+      push_block(size, size);
+    } else if (nullptr != spare) {
+      push_block(spare->size, spare->size);
+    }
+    stats_.bytes_in_use = 0;
+  }
+
+  // Frees every allocation and returns all memory to operator new.
+  INLINE void release() {
+    while (nullptr != current) pop_block();
+    delete_blocks(spare);
+    spare = nullptr;
+    capacity_ = 0;
+    stats_.bytes_in_use = 0;
+  }
+
+  // Bytes obtained from operator new and not yet released, spare blocks included
+  ALWAYS_INLINE_HIDDEN std::size_t capacity() const { return capacity_; }
+
+  ALWAYS_INLINE_HIDDEN arena_stats const& stats() const { return stats_; }
+};
+
+// Arena private to the calling thread, so parallel workers take scratch memory without
+// synchronising. task_scheduler rewinds it after each fork_join leaf and resets it between a
+// worker's tasks.
+INLINE arena& thread_arena() {
+  static thread_local arena x;
+  return x;
+}
+
+// Standard allocator drawing from an arena, e.g. for a std::vector of scratch values.
+// deallocate does nothing; the memory is recovered by resetting the arena.
+template<typename T>
+struct TYPE_DEFAULT_VISIBILITY arena_allocator
+{
+  typedef T value_type;
+  arena* source;
+
+  ALWAYS_INLINE_HIDDEN arena_allocator(arena& x) : source(&x) {}
+
+  template<typename U>
+  ALWAYS_INLINE_HIDDEN arena_allocator(arena_allocator<U> const& x) : source(x.source) {}
+
+  ALWAYS_INLINE_HIDDEN T* allocate(std::size_t n) { return source->allocate_array<T>(n); }
+
+  ALWAYS_INLINE_HIDDEN void deallocate(T*, std::size_t) {}
+
+  template<typename U>
+  friend ALWAYS_INLINE_HIDDEN bool operator==(arena_allocator const& x, arena_allocator<U> const& y) { return x.source == y.source; }
+
+  template<typename U>
+  friend ALWAYS_INLINE_HIDDEN bool operator!=(arena_allocator const& x, arena_allocator<U> const& y) { return x.source != y.source; }
+};
+
+} // namespace range2
+
+#endif
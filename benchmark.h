@@ -0,0 +1,175 @@
+#ifndef INCLUDED_BENCHMARK
+#define INCLUDED_BENCHMARK
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_TIMER
+#include "timer.h"
+#endif
+
+#ifndef INCLUDED_PERF_COUNTERS
+#include "perf_counters.h"
+#endif
+
+#ifndef INCLUDED_LATENCY_HISTOGRAM
+#include "latency_histogram.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHM
+#define INCLUDED_ALGORITHM
+#include <algorithm>
+#endif
+
+#ifndef INCLUDED_CASSERT
+#define INCLUDED_CASSERT
+#include <cassert>
+#endif
+
+#ifndef INCLUDED_CMATH
+#define INCLUDED_CMATH
+#include <cmath>
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+#ifndef INCLUDED_OSTREAM
+#define INCLUDED_OSTREAM
+#include <ostream>
+#endif
+
+#ifndef INCLUDED_VECTOR
+#define INCLUDED_VECTOR
+#include <vector>
+#endif
+
+namespace range2 {
+
+// Forces x to be computed, and kept, without otherwise constraining the optimiser.
+template<typename T>
+ALWAYS_INLINE_HIDDEN void do_not_optimize(T const& x) {
+  asm volatile("" : : "r,m"(x) : "memory");
+}
+
+// Forces pending writes to memory to be performed.
+ALWAYS_INLINE_HIDDEN void clobber_memory() {
+  asm volatile("" : : : "memory");
+}
+
+// Runs are repeated, after the warm up runs, until the 95% confidence interval of the mean is
+// within relative_error of it, or until max_runs or max_nanoseconds is reached.
+// count_events collects hardware performance counters around each run, where permitted.
+struct TYPE_DEFAULT_VISIBILITY benchmark_options
+{
+  int warmup_runs;
+  int min_runs;
+  int max_runs;
+  double max_nanoseconds;
+  double relative_error;
+  bool count_events;
+};
+
+// Times per run in nanoseconds; counts are the mean per run.
+struct TYPE_DEFAULT_VISIBILITY benchmark_result
+{
+  int runs;
+  double min;
+  double median;
+  double p95;
+  double mean;
+  double relative_error;
+  double nanoseconds_per_element;
+  double gigabytes_per_second;
+  std::size_t elements;
+  perf_counts counts;
+};
+
+namespace impl {
+
+// Half width of the 95% confidence interval of the mean, relative to the mean.
+INLINE double relative_confidence(std::vector<double> const& samples) {
+  double n = double(samples.size());
+  double mean = 0.0;
+  for (double x : samples) mean += x;
+  mean /= n;
+  double variance = 0.0;
+  for (double x : samples) variance += (x - mean) * (x - mean);
+  variance /= (n - 1.0);
+  return 1.96 * std::sqrt(variance / n) / mean;
+}
+
+INLINE benchmark_result summarise(std::vector<double> samples, perf_counts counts, std::size_t elements, std::size_t bytes) {
+  benchmark_result result;
+  result.runs = static_cast<int>(samples.size());
+  for (double& x : counts.values) if (x >= 0.0) x /= double(result.runs);
+  result.counts = counts;
+  result.elements = elements;
+  result.relative_error = relative_confidence(samples);
+  result.mean = 0.0;
+  for (double x : samples) result.mean += x;
+  result.mean /= double(samples.size());
+  std::sort(samples.begin(), samples.end());
+  result.min = samples.front();
+  result.median = samples[samples.size() / 2];
+  result.p95 = samples[(samples.size() * 95) / 100];
+  result.nanoseconds_per_element = (0 == elements) ? 0.0 : result.median / double(elements);
+  result.gigabytes_per_second = double(bytes) / result.median;
+  return result;
+}
+
+} // namespace impl
+
+// Times op(), which processes elements values occupying bytes, passing each result to
+// do_not_optimize. Statistics use the median, so an interrupted run does not skew them.
+template<typename Op>
+INLINE benchmark_result run_benchmark(Op op, std::size_t elements, std::size_t bytes,
+                                      benchmark_options options = benchmark_options{1, 5, 1000, 2e8, 0.01, true}) {
+  assert(options.min_runs >= 2 && options.max_runs >= options.min_runs);
+  for (int i = 0; i < options.warmup_runs; ++i) do_not_optimize(op());
+
+  std::vector<double> samples;
+  double total = 0.0;
+  perf_counters counters(options.count_events);
+  perf_counts counts = counters.is_open() ? make_zero_perf_counts() : make_unavailable_perf_counts();
+  timer t;
+  do {
+    if (counters.is_open()) counters.start();
+    t.start();
+    do_not_optimize(op());
+    double time = t.stop();
+    if (counters.is_open()) counts += counters.stop();
+    samples.push_back(time);
+    total += time;
+  } while (static_cast<int>(samples.size()) < options.min_runs ||
+           (static_cast<int>(samples.size()) < options.max_runs && total < options.max_nanoseconds &&
+            impl::relative_confidence(samples) > options.relative_error));
+  return impl::summarise(cmove(samples), counts, elements, bytes);
+}
+
+INLINE std::ostream& report(std::ostream& o, benchmark_result const& x, char const* description) {
+  o << "median " << x.median << "ns p95 " << x.p95 << "ns min " << x.min << "ns "
+    << x.nanoseconds_per_element << "ns/element ";
+  if (0.0 != x.gigabytes_per_second) o << x.gigabytes_per_second << "GB/s ";
+  if (0.0 <= x.counts.instructions_per_cycle()) o << "IPC " << x.counts.instructions_per_cycle() << ' ';
+  // Misses per element, which compare across Range forms regardless of run length
+  for (int i = perf_event::branch_misses; i != perf_event::size; ++i) {
+    if (x.counts.available(i) && 0 != x.elements) o << perf_event_name(i) << ' ' << x.counts.values[i] / double(x.elements) << "/element ";
+  }
+  return o << '(' << x.runs << " runs +-" << (100.0 * x.relative_error) << "%)" << description << '\n';
+}
+
+// Distribution of per call latencies recorded in nanoseconds, e.g. with cycle_timer.
+INLINE std::ostream& report(std::ostream& o, latency_histogram const& x, char const* description) {
+  if (0 == x.count()) return o << "no samples" << description << '\n';
+  return o << "p50 " << x.percentile(50.0) << "ns p90 " << x.percentile(90.0) << "ns p99 " << x.percentile(99.0)
+           << "ns p99.9 " << x.percentile(99.9) << "ns min " << x.min() << "ns max " << x.max() << "ns mean "
+           << x.mean() << "ns (" << x.count() << " calls)" << description << '\n';
+}
+
+} // namespace range2
+
+#endif
@@ -0,0 +1,292 @@
+#ifndef INCLUDED_BIT_RANGE
+#define INCLUDED_BIT_RANGE
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHMS
+#include "algorithms.h"
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+#ifndef INCLUDED_CSTDINT
+#define INCLUDED_CSTDINT
+#include <cstdint>
+#endif
+
+#ifndef INCLUDED_FUNCTIONAL
+#define INCLUDED_FUNCTIONAL
+#include <functional>
+#endif
+
+#ifndef INCLUDED_VECTOR
+#define INCLUDED_VECTOR
+#include <vector>
+#endif
+
+namespace range2 {
+
+typedef std::uint64_t bit_word;
+
+constexpr std::ptrdiff_t bits_per_word = 64;
+
+namespace impl {
+
+// The n least significant bits set, 0 <= n <= bits_per_word.
+constexpr ALWAYS_INLINE_HIDDEN bit_word low_bits(std::ptrdiff_t n) {
+  return (n >= bits_per_word) ? ~bit_word(0) : ((bit_word(1) << n) - 1);
+}
+
+} // namespace impl
+
+// Proxy for a single bit, as a reference into a packed bit_word array.
+template<typename Word>
+struct TYPE_DEFAULT_VISIBILITY bit_reference
+{
+  Word* word;
+  unsigned bit;
+
+  ALWAYS_INLINE_HIDDEN operator bool() const { return (*word >> bit) & 1; }
+
+  ALWAYS_INLINE_HIDDEN bit_reference& operator=(bool x) {
+    static_assert(!std::is_const<Word>::value, "Cannot assign through a read only bit_reference");
+    if (x) *word |= bit_word(1) << bit;
+    else *word &= ~(bit_word(1) << bit);
+    return *this;
+  }
+
+  ALWAYS_INLINE_HIDDEN bit_reference& operator=(bit_reference const& x) { return *this = bool(x); }
+};
+
+// Random access iterator over bits packed least significant first into bit_words;
+// Word is bit_word or bit_word const.
+template<typename Word>
+struct TYPE_DEFAULT_VISIBILITY bit_iterator_basis {
+  typedef pair<Word*, unsigned> state_type;
+  Word* word;
+  unsigned bit;
+  typedef bool value_type;
+  typedef bit_reference<Word> reference;
+  typedef void pointer;
+  typedef std::ptrdiff_t difference_type;
+  typedef std::random_access_iterator_tag iterator_category;
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  reference deref(bit_iterator_basis const& x) { return {x.word, x.bit}; }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  bit_iterator_basis successor(bit_iterator_basis const& x) {
+    return (x.bit + 1 == bits_per_word) ? bit_iterator_basis{x.word + 1, 0} : bit_iterator_basis{x.word, x.bit + 1};
+  }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  bit_iterator_basis predecessor(bit_iterator_basis const& x) {
+    return (0 == x.bit) ? bit_iterator_basis{x.word - 1, bits_per_word - 1} : bit_iterator_basis{x.word, x.bit - 1};
+  }
+
+  // Arithmetic shift and mask give floor division and modulus for negative offsets too
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  bit_iterator_basis offset(bit_iterator_basis const& x, difference_type i) {
+    return {x.word + ((x.bit + i) >> 6), static_cast<unsigned>((x.bit + i) & (bits_per_word - 1))};
+  }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  difference_type difference(bit_iterator_basis const& x, bit_iterator_basis const& y) {
+    return (x.word - y.word) * bits_per_word + difference_type(x.bit) - difference_type(y.bit);
+  }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  state_type state(bit_iterator_basis const& x) { return range2::make_pair(x.word, x.bit); }
+};
+
+template<typename Word>
+struct TYPE_HIDDEN_VISIBILITY AutomaticallyGenerateSink<bit_iterator_basis<Word>> : std::false_type {};
+
+template<typename Word, typename T>
+ALWAYS_INLINE_HIDDEN void sink(bit_iterator_basis<Word> const& x, T&& y) {
+  static_assert(std::is_convertible<T, bool>::value, "Value to sink must be convertible to value type of Iterator");
+  deref(x) = bool(std::forward<T>(y));
+}
+
+template<typename Word>
+using bit_iterator = iterator<bit_iterator_basis<Word>>;
+
+// Counted Range over the n bits stored from the least significant bit of words[0].
+template<typename Word>
+ALWAYS_INLINE_HIDDEN Range<bit_iterator<Word>, Present, Present>
+make_bit_range(Word* words, std::ptrdiff_t n) {
+  return make_range(bit_iterator<Word>{{words, 0}}, bit_iterator<Word>{{words, 0}} + n, n);
+}
+
+// Growable packed sequence of bits; unused bits of the last word are kept clear.
+class TYPE_DEFAULT_VISIBILITY bit_vector
+{
+  std::vector<bit_word> words_;
+  std::ptrdiff_t size_;
+
+public:
+  ALWAYS_INLINE_HIDDEN bit_vector() : size_(0) {}
+
+  ALWAYS_INLINE_HIDDEN explicit bit_vector(std::ptrdiff_t n, bool value = false)
+    : words_((n + bits_per_word - 1) / bits_per_word, value ? ~bit_word(0) : bit_word(0)), size_(n) {
+    if (value && 0 != n % bits_per_word) words_.back() = impl::low_bits(n % bits_per_word);
+  }
+
+  ALWAYS_INLINE_HIDDEN std::ptrdiff_t size() const { return size_; }
+
+  ALWAYS_INLINE_HIDDEN void push_back(bool x) {
+    if (0 == size_ % bits_per_word) words_.push_back(0);
+    words_.back() |= bit_word(x) << (size_ % bits_per_word);
+    ++size_;
+  }
+
+  ALWAYS_INLINE_HIDDEN std::vector<bit_word> const& words() const { return words_; }
+
+  ALWAYS_INLINE_HIDDEN Range<bit_iterator<bit_word>, Present, Present> range() {
+    return make_bit_range(words_.data(), size_);
+  }
+
+  ALWAYS_INLINE_HIDDEN Range<bit_iterator<bit_word const>, Present, Present> range() const {
+    return make_bit_range(words_.data(), size_);
+  }
+};
+
+
+// Predicates on bit iterators which the overloads below evaluate a word at a time,
+// e.g. count_if(flags.range(), bit_is_set{}, std::ptrdiff_t(0)).
+struct TYPE_DEFAULT_VISIBILITY bit_is_set
+{
+  template<typename I>
+  ALWAYS_INLINE_HIDDEN bool operator()(I const& x) const { return deref(x); }
+};
+
+typedef complement<bit_is_set> bit_is_clear;
+
+template<typename Pred>
+struct TYPE_HIDDEN_VISIBILITY BitPredicate : std::false_type {};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY BitPredicate<bit_is_set> : std::true_type {
+  static constexpr bool bit_value = true;
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY BitPredicate<bit_is_clear> : std::true_type {
+  static constexpr bool bit_value = false;
+};
+
+// Reductions of bools which depend only on how many of n values are true.
+template<typename Op>
+struct TYPE_HIDDEN_VISIBILITY BitReduction : std::false_type {};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY BitReduction<std::logical_or<bool>> : std::true_type {
+  static constexpr ALWAYS_INLINE_HIDDEN bool apply(std::ptrdiff_t k, std::ptrdiff_t) { return 0 != k; }
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY BitReduction<std::logical_and<bool>> : std::true_type {
+  static constexpr ALWAYS_INLINE_HIDDEN bool apply(std::ptrdiff_t k, std::ptrdiff_t n) { return n == k; }
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY BitReduction<std::not_equal_to<bool>> : std::true_type {
+  static constexpr ALWAYS_INLINE_HIDDEN bool apply(std::ptrdiff_t k, std::ptrdiff_t) { return 0 != (k & 1); }
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY BitReduction<std::bit_xor<bool>> : BitReduction<std::not_equal_to<bool>> {};
+
+namespace impl {
+
+// Number of set bits in [x, x + n).
+template<typename Word>
+INLINE std::ptrdiff_t count_set_bits(bit_iterator_basis<Word> x, std::ptrdiff_t n) {
+  if (0 == n) return 0;
+  Word* w = x.word;
+  bit_word const leading = *w >> x.bit;
+  std::ptrdiff_t const k = n < bits_per_word - x.bit ? n : bits_per_word - x.bit;
+  std::ptrdiff_t result = POPCOUNT64(leading & low_bits(k));
+  n -= k;
+  ++w;
+  // Independent accumulators so the loop is bound by memory bandwidth, not the add chain
+  std::ptrdiff_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+  for (; n >= 4 * bits_per_word; n -= 4 * bits_per_word, w += 4) {
+    r0 += POPCOUNT64(w[0]);
+    r1 += POPCOUNT64(w[1]);
+    r2 += POPCOUNT64(w[2]);
+    r3 += POPCOUNT64(w[3]);
+  }
+  for (; n >= bits_per_word; n -= bits_per_word, ++w) r0 += POPCOUNT64(*w);
+  if (0 != n) r0 += POPCOUNT64(*w & low_bits(n));
+  return result + r0 + r1 + r2 + r3;
+}
+
+// Offset of the first bit equal to value in [x, x + n), or n if there is none.
+template<typename Word>
+INLINE std::ptrdiff_t find_bit(bit_iterator_basis<Word> x, std::ptrdiff_t n, bool value) {
+  if (0 == n) return 0;
+  bit_word const flip = value ? bit_word(0) : ~bit_word(0);
+  std::ptrdiff_t const limit = n + x.bit;
+  Word* w = x.word;
+  bit_word bits = (*w ^ flip) & ~low_bits(x.bit);
+  std::ptrdiff_t base = 0;
+  while (0 == bits) {
+    base += bits_per_word;
+    if (base >= limit) return n;
+    bits = *++w ^ flip;
+  }
+  std::ptrdiff_t const found = base + COUNT_TRAILING_ZEROES64(bits);
+  return (found < limit ? found : limit) - x.bit;
+}
+
+} // namespace impl
+
+// Overloads of the algorithms for bit ranges and bit predicates, found by ADL from the
+// public wrappers, which test 64 bits per step using popcount and count trailing zeroes.
+
+template<typename Word, typename End, typename Pred>
+INLINE typename std::enable_if<BitPredicate<Pred>::value, Range<bit_iterator<Word>, End, Present>>::type
+find_if_impl(Range<bit_iterator<Word>, End, Present> r, Pred) {
+  auto i = impl::find_bit(get_begin(r).basis, get_count(r), BitPredicate<Pred>::bit_value);
+  return make_range(get_begin(r) + i, get_end(r), get_count(r) - i);
+}
+
+template<typename Word, typename End, typename Pred, typename CountType>
+INLINE typename std::enable_if<BitPredicate<Pred>::value, CountType>::type
+count_if_impl(Range<bit_iterator<Word>, End, Present> r, Pred, CountType c) {
+  auto k = impl::count_set_bits(get_begin(r).basis, get_count(r));
+  return c + CountType(BitPredicate<Pred>::bit_value ? k : get_count(r) - k);
+}
+
+// Requires Func to be a bit predicate and Op one of the BitReduction operations.
+// As the generic reduce, the first bit seeds the state as it is and Func maps only the rest.
+template<typename Word, typename End, typename Op, typename Func>
+INLINE typename std::enable_if<BitPredicate<Func>::value && BitReduction<Op>::value, pair<bool, Range<bit_iterator<Word>, End, Present>>>::type
+reduce_impl(Range<bit_iterator<Word>, End, Present> r, Op, Func, bool const& z) {
+  if (is_empty(r)) return range2::make_pair(z, r);
+  auto n = get_count(r);
+  auto k = impl::count_set_bits(get_begin(r).basis, n);
+  decltype(k) const first = deref(get_begin(r)) ? 1 : 0;
+  auto rest = BitPredicate<Func>::bit_value ? k - first : (n - 1) - (k - first);
+  return range2::make_pair(BitReduction<Op>::apply(first + rest, n),
+                           make_range(get_begin(r) + n, get_end(r), n - n));
+}
+
+template<typename Word, typename End, typename Pred>
+INLINE typename std::enable_if<BitPredicate<Pred>::value, bool>::type
+partitioned_impl(Range<bit_iterator<Word>, End, Present> r, Pred) {
+  bool const value = BitPredicate<Pred>::bit_value;
+  auto n = get_count(r);
+  auto i = impl::find_bit(get_begin(r).basis, n, !value);
+  return n - i == impl::find_bit((get_begin(r) + i).basis, n - i, value);
+}
+
+} // namespace range2
+
+#endif
@@ -0,0 +1 @@
+#include "byte_search.h"
@@ -0,0 +1,216 @@
+#ifndef INCLUDED_BYTE_SEARCH
+#define INCLUDED_BYTE_SEARCH
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHMS
+#include "algorithms.h"
+#endif
+
+#ifndef INCLUDED_CASSERT
+#define INCLUDED_CASSERT
+#include <cassert>
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+#ifndef INCLUDED_CSTDINT
+#define INCLUDED_CSTDINT
+#include <cstdint>
+#endif
+
+#ifndef INCLUDED_CSTRING
+#define INCLUDED_CSTRING
+#include <cstring>
+#endif
+
+#ifndef INCLUDED_FUNCTIONAL
+#define INCLUDED_FUNCTIONAL
+#include <functional>
+#endif
+
+#ifdef __SSE2__
+#ifndef INCLUDED_EMMINTRIN
+#define INCLUDED_EMMINTRIN
+#include <emmintrin.h>
+#endif
+#endif
+
+namespace range2 {
+
+template<typename T>
+struct TYPE_HIDDEN_VISIBILITY IsByte : std::integral_constant<bool,
+  std::is_same<typename std::remove_cv<T>::type, char>::value ||
+  std::is_same<typename std::remove_cv<T>::type, signed char>::value ||
+  std::is_same<typename std::remove_cv<T>::type, unsigned char>::value> {};
+
+// Predicate on iterators over bytes, e.g. find_if(line, byte_equal_to{'\n'}).
+// Over contiguous byte ranges find_if uses memchr.
+struct TYPE_DEFAULT_VISIBILITY byte_equal_to
+{
+  unsigned char value;
+
+  template<typename I>
+  ALWAYS_INLINE_HIDDEN bool operator()(I const& x) const { return value == static_cast<unsigned char>(deref(x)); }
+};
+
+// Set of up to max_size bytes, tested with a bitmap or, 16 bytes at a time, by comparing
+// against each member.
+class TYPE_DEFAULT_VISIBILITY byte_set
+{
+public:
+  static constexpr unsigned max_size = 16;
+
+private:
+  unsigned size_;
+  std::uint64_t table[4];
+#ifdef __SSE2__
+  __m128i splat[max_size];
+#endif
+
+public:
+  ALWAYS_INLINE_HIDDEN byte_set() : size_(0), table() {}
+
+  ALWAYS_INLINE_HIDDEN void insert(unsigned char x) {
+    if (contains(x)) return;
+    assert(size_ < max_size);
+#ifdef __SSE2__
+    splat[size_] = _mm_set1_epi8(static_cast<char>(x));
+#endif
+    ++size_;
+    table[x >> 6] |= std::uint64_t(1) << (x & 63);
+  }
+
+  ALWAYS_INLINE_HIDDEN bool contains(unsigned char x) const { return 0 != ((table[x >> 6] >> (x & 63)) & 1); }
+
+  ALWAYS_INLINE_HIDDEN unsigned size() const { return size_; }
+
+#ifdef __SSE2__
+  // Bytes of block equal to a member, as a mask with bit i set for byte i.
+  ALWAYS_INLINE_HIDDEN int match(__m128i block) const {
+    __m128i hits = _mm_cmpeq_epi8(block, splat[0]);
+    for (unsigned k = 1; k < size_; ++k) hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, splat[k]));
+    return _mm_movemask_epi8(hits);
+  }
+#endif
+};
+
+// Byte set of the characters of a null terminated string.
+INLINE byte_set make_byte_set(char const* x) {
+  byte_set tmp;
+  while (*x) tmp.insert(static_cast<unsigned char>(*x++));
+  return tmp;
+}
+
+// Predicate on iterators over bytes testing membership of a byte_set, e.g.
+//   find_if(line, make_byte_set_pred(&delimiters))
+// Over contiguous byte ranges find_if compares 16 bytes per step against every member.
+struct TYPE_DEFAULT_VISIBILITY byte_set_pred
+{
+  byte_set const* set;
+
+  template<typename I>
+  ALWAYS_INLINE_HIDDEN bool operator()(I const& x) const { return set->contains(static_cast<unsigned char>(deref(x))); }
+};
+
+ALWAYS_INLINE_HIDDEN byte_set_pred make_byte_set_pred(byte_set const* x) {
+  return {x};
+}
+
+namespace impl {
+
+template<typename T>
+ALWAYS_INLINE_HIDDEN unsigned char const* as_bytes(T* x) { return reinterpret_cast<unsigned char const*>(x); }
+
+// Offset of the first byte of [x, x + n) in s, or n if there is none.
+INLINE std::ptrdiff_t find_byte_in_set(unsigned char const* x, std::ptrdiff_t n, byte_set const& s) {
+  std::ptrdiff_t i = 0;
+#ifdef __SSE2__
+  if (0 == s.size()) return n;
+  for (; i + 16 <= n; i += 16) {
+    int const mask = s.match(_mm_loadu_si128(reinterpret_cast<__m128i const*>(x + i)));
+    if (0 != mask) return i + __builtin_ctz(mask);
+  }
+#endif
+  while (i != n && !s.contains(x[i])) ++i;
+  return i;
+}
+
+// Offset of the first occurrence of [y, y + m) in [x, x + n), or n if there is none.
+// Candidates must match both the first and last byte of the needle, tested 16 positions per
+// step, before the bytes between are compared.
+INLINE std::ptrdiff_t find_bytes(unsigned char const* x, std::ptrdiff_t n, unsigned char const* y, std::ptrdiff_t m) {
+  if (m < 2) {
+    if (0 == m) return 0;
+    void const* found = (0 == n) ? nullptr : std::memchr(x, y[0], n);
+    return found ? static_cast<unsigned char const*>(found) - x : n;
+  }
+  std::ptrdiff_t const candidates = n - m + 1;
+  std::ptrdiff_t i = 0;
+#ifdef __SSE2__
+  __m128i const first = _mm_set1_epi8(static_cast<char>(y[0]));
+  __m128i const last = _mm_set1_epi8(static_cast<char>(y[m - 1]));
+  for (; i + 16 <= candidates; i += 16) {
+    __m128i const b0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(x + i));
+    __m128i const b1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(x + i + m - 1));
+    unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b0, first), _mm_cmpeq_epi8(b1, last)));
+    while (0 != mask) {
+      unsigned const j = __builtin_ctz(mask);
+      if (0 == std::memcmp(x + i + j + 1, y + 1, m - 2)) return i + j;
+      mask &= mask - 1;
+    }
+  }
+#endif
+  for (; i < candidates; ++i) {
+    if (x[i] == y[0] && x[i + m - 1] == y[m - 1] && 0 == std::memcmp(x + i + 1, y + 1, m - 2)) return i;
+  }
+  return n;
+}
+
+template<typename Rel>
+struct TYPE_HIDDEN_VISIBILITY IsByteEquality : std::false_type {};
+
+template<typename T>
+struct TYPE_HIDDEN_VISIBILITY IsByteEquality<deref_op<std::equal_to<T>>> : IsByte<T> {};
+
+} // namespace impl
+
+// Overloads of the algorithms for contiguous byte ranges, found by ADL from the public wrappers.
+
+template<typename T, typename End>
+INLINE typename std::enable_if<IsByte<T>::value, Range<T*, End, Present>>::type
+find_if_impl(Range<T*, End, Present> r, byte_equal_to p) {
+  auto n = get_count(r);
+  void const* found = (0 == n) ? nullptr : std::memchr(get_begin(r), p.value, n);
+  auto i = found ? static_cast<unsigned char const*>(found) - impl::as_bytes(get_begin(r)) : n;
+  return make_range(get_begin(r) + i, get_end(r), n - i);
+}
+
+template<typename T, typename End>
+INLINE typename std::enable_if<IsByte<T>::value, Range<T*, End, Present>>::type
+find_if_impl(Range<T*, End, Present> r, byte_set_pred p) {
+  auto n = get_count(r);
+  auto i = impl::find_byte_in_set(impl::as_bytes(get_begin(r)), n, *p.set);
+  return make_range(get_begin(r) + i, get_end(r), n - i);
+}
+
+template<typename T, typename End, typename U, typename End1, typename Rel>
+INLINE typename std::enable_if<IsByte<T>::value && IsByte<U>::value && impl::IsByteEquality<Rel>::value,
+                               pair<Range<T*, Present, Present>, Range<T*, End, Present>>>::type
+search_impl(Range<T*, End, Present> r0, Range<U*, End1, Present> r1, Rel) {
+  auto n = get_count(r0);
+  auto m = get_count(r1);
+  auto i = impl::find_bytes(impl::as_bytes(get_begin(r0)), n, impl::as_bytes(get_begin(r1)), m);
+  if (i == n) m = 0;
+  T* match = get_begin(r0) + i;
+  return range2::make_pair(make_range(match, match + m, m), make_range(match + m, get_end(r0), n - i - m));
+}
+
+} // namespace range2
+
+#endif
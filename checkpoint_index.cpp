@@ -0,0 +1 @@
+#include "checkpoint_index.h"
@@ -0,0 +1,122 @@
+#ifndef INCLUDED_CHECKPOINT_INDEX
+#define INCLUDED_CHECKPOINT_INDEX
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHMS
+#include "algorithms.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHM
+#define INCLUDED_ALGORITHM
+#include <algorithm>
+#endif
+
+#ifndef INCLUDED_VECTOR
+#define INCLUDED_VECTOR
+#include <vector>
+#endif
+
+namespace range2 {
+
+// Every stride-th iterator of a counted forward range, recorded in one walk so that searches of
+// a sorted linked structure bisect the checkpoints and then scan fewer than stride elements,
+// rather than advancing from the start of the remaining range on every probe.
+// Valid while the elements of the range are neither inserted nor erased.
+template<typename Rng>
+class TYPE_DEFAULT_VISIBILITY checkpoint_index
+{
+public:
+  typedef RangeIterator<Rng> iterator;
+  typedef RangeDifferenceType<Rng> difference_type;
+
+private:
+  Rng r;
+  difference_type stride_;
+  std::vector<iterator> checkpoints_;
+
+public:
+  // Precondition: stride > 0
+  checkpoint_index(Rng x, difference_type stride) : r(cmove(x)), stride_(stride), checkpoints_() {
+    checkpoints_.reserve(get_count(r) / stride + 1);
+    auto tmp = make_range(get_begin(r), NotPresent{}, get_count(r));
+    while (!is_empty(tmp)) {
+      checkpoints_.push_back(get_begin(tmp));
+      auto n = std::min(stride, get_count(tmp));
+      tmp = make_range(range2::advance(get_begin(tmp), n), NotPresent{}, get_count(tmp) - n);
+    }
+  }
+
+  ALWAYS_INLINE_HIDDEN Rng const& range() const { return r; }
+
+  ALWAYS_INLINE_HIDDEN difference_type stride() const { return stride_; }
+
+  ALWAYS_INLINE_HIDDEN std::vector<iterator> const& checkpoints() const { return checkpoints_; }
+};
+
+template<typename Range>
+ALWAYS_INLINE_HIDDEN auto make_checkpoint_index(Range r, RangeDifferenceType<Range> stride) -> checkpoint_index<decltype( add_linear_time_count(r) )> {
+  static_assert(IsAFiniteRange<Range>::value, "Must be a finite range to index it");
+  return {add_linear_time_count(r), stride};
+}
+
+namespace impl {
+
+// Applies Pred to the iterator a checkpoint records.
+template<typename Pred>
+struct TYPE_HIDDEN_VISIBILITY checkpoint_pred {
+  Pred pred;
+
+  template<typename Iterator>
+  ALWAYS_INLINE_HIDDEN bool operator()(Iterator const* x) {
+    return pred(*x);
+  }
+};
+
+} // namespace impl
+
+// As partition_point over x.range(), with O(log(n / stride)) applications of pred to the
+// checkpoints followed by fewer than stride successors.
+template<typename Rng, typename Pred>
+ALWAYS_INLINE_HIDDEN pair<Range<RangeIterator<Rng>, Present, Present>, Range<RangeIterator<Rng>, typename GetEnd<Rng>::type, Present>>
+partition_point(checkpoint_index<Rng> const& x, Pred pred) {
+  auto const& c = x.checkpoints();
+  auto const& r = x.range();
+  auto blocks = partition_point_impl(make_range(c.data(), NotPresent{}, RangeDifferenceType<Rng>(c.size())), impl::checkpoint_pred<Pred>{pred});
+  auto j = get_count(blocks.m0);
+  auto iter = get_begin(r);
+  auto lhsN = decltype(j)(0);
+  if (0 != j) {
+    // pred is false at checkpoint j - 1 and true at checkpoint j, if there is one.
+    auto offset = (j - 1) * x.stride();
+    auto n = std::min(x.stride(), get_count(r) - offset);
+    auto tmp = find_if_impl(make_range(successor(c[j - 1]), NotPresent{}, n - 1), pred);
+    iter = get_begin(tmp);
+    lhsN = offset + n - get_count(tmp);
+  }
+  return range2::make_pair(make_range(get_begin(r), iter, lhsN), make_range(iter, get_end(r), get_count(r) - lhsN));
+}
+
+template<typename Rng, typename Rel>
+ALWAYS_INLINE_HIDDEN auto lower_bound_predicate(checkpoint_index<Rng> const& x, Rel rel, RangeValue<Rng> const& a) -> decltype( partition_point(x, impl::make_lower_bound_pred(&a, rel)) ) {
+  return partition_point(x, impl::make_lower_bound_pred(&a, rel));
+}
+
+template<typename Rng, typename Rel>
+ALWAYS_INLINE_HIDDEN auto upper_bound_predicate(checkpoint_index<Rng> const& x, Rel rel, RangeValue<Rng> const& a) -> decltype( partition_point(x, impl::make_upper_bound_pred(&a, rel)) ) {
+  return partition_point(x, impl::make_upper_bound_pred(&a, rel));
+}
+
+template<typename Rng, typename Rel>
+ALWAYS_INLINE_HIDDEN triple<Range<RangeIterator<Rng>, Present, Present>, Range<RangeIterator<Rng>, Present, Present>, Range<RangeIterator<Rng>, typename GetEnd<Rng>::type, Present>>
+equivalent_range(checkpoint_index<Rng> const& x, Rel rel, RangeValue<Rng> const& a) {
+  auto lower = lower_bound_predicate(x, rel, a);
+  auto upper = upper_bound_predicate(x, rel, a);
+  return make_triple(lower.m0, make_range(get_begin(lower.m1), get_begin(upper.m1), get_count(upper.m0) - get_count(lower.m0)), upper.m1);
+}
+
+} // namespace range2
+
+#endif
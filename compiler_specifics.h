@@ -38,15 +38,34 @@
 #endif
 
 #ifndef INTROSPECTION_EXPECT
-#define INTROSPECTION_EXPECT(Expected, Actual) __builtin_expect(Expected, (Actual))
+#define INTROSPECTION_EXPECT(Expected, Actual) __builtin_expect((Actual), Expected)
 #endif
 
 #ifndef INTROSPECTION_LIKELY
-#define INTROSPECTION_LIKELY(x) __builtin_expect(true, !!(x))
+#define INTROSPECTION_LIKELY(x) __builtin_expect(!!(x), true)
 #endif
 
 #ifndef INTROSPECTION_UNLIKELY
-#define INTROSPECTION_UNLIKELY(x) __builtin_expect(false, !!(x))
+#define INTROSPECTION_UNLIKELY(x) __builtin_expect(!!(x), false)
+#endif
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+// Read-prefetch hint; never faults so may be given any address.
+#ifndef PREFETCH_READ
+#define PREFETCH_READ(x) __builtin_prefetch((x), 0, 3)
+#endif
+
+// An out of line library call unless a popcount instruction is enabled, e.g. with -mpopcnt.
+#ifndef POPCOUNT64
+#define POPCOUNT64(x) __builtin_popcountll(x)
+#endif
+
+// Undefined for zero.
+#ifndef COUNT_TRAILING_ZEROES64
+#define COUNT_TRAILING_ZEROES64(x) __builtin_ctzll(x)
 #endif
 
 #endif
@@ -0,0 +1 @@
+#include "compressed_column.h"
@@ -0,0 +1,184 @@
+#ifndef INCLUDED_COMPRESSED_COLUMN
+#define INCLUDED_COMPRESSED_COLUMN
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHMS
+#include "algorithms.h"
+#endif
+
+#ifndef INCLUDED_CASSERT
+#define INCLUDED_CASSERT
+#include <cassert>
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+#ifndef INCLUDED_VECTOR
+#define INCLUDED_VECTOR
+#include <vector>
+#endif
+
+namespace range2 {
+
+namespace impl {
+
+// LEB128: seven bits per byte, least significant first, high bit set on all but the last byte.
+template<typename T>
+ALWAYS_INLINE_HIDDEN void encode_varint(std::vector<unsigned char>& bytes, T x) {
+  while (x >= 0x80) {
+    bytes.push_back(static_cast<unsigned char>(x | 0x80));
+    x >>= 7;
+  }
+  bytes.push_back(static_cast<unsigned char>(x));
+}
+
+template<typename T>
+ALWAYS_INLINE_HIDDEN pair<T, unsigned char const*> decode_varint(unsigned char const* x) {
+  T value = *x & 0x7f;
+  unsigned shift = 7;
+  while (*x & 0x80) {
+    ++x;
+    value |= T(*x & 0x7f) << shift;
+    shift += 7;
+  }
+  return range2::make_pair(value, x + 1);
+}
+
+} // namespace impl
+
+template<typename T>
+class compressed_column;
+
+// Forward iterator decoding a compressed_column. position addresses the encoded difference
+// between the current value and base, the previous value.
+template<typename T>
+struct TYPE_DEFAULT_VISIBILITY compressed_column_iterator_basis {
+  typedef unsigned char const* state_type;
+  state_type position;
+  typedef T value_type;
+  typedef T reference;
+  typedef T const* pointer;
+  typedef std::ptrdiff_t difference_type;
+  typedef std::forward_iterator_tag iterator_category;
+  T base;
+  difference_type index;
+  compressed_column<T> const* column;
+
+  friend ALWAYS_INLINE_HIDDEN
+  reference deref(compressed_column_iterator_basis const& x) { return x.base + impl::decode_varint<T>(x.position).m0; }
+
+  friend ALWAYS_INLINE_HIDDEN
+  compressed_column_iterator_basis successor(compressed_column_iterator_basis const& x) {
+    auto tmp = impl::decode_varint<T>(x.position);
+    return {tmp.m1, x.base + tmp.m0, x.index + 1, x.column};
+  }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  state_type state(compressed_column_iterator_basis const& x) { return x.position; }
+};
+
+template<typename T>
+using compressed_column_iterator = iterator<compressed_column_iterator_basis<T>>;
+
+// Sorted column of unsigned integers stored as varint encoded differences, with the absolute
+// value and byte offset of every block_size-th value indexed so a search can jump to the block
+// holding its answer and scan only within it.
+// Appending invalidates iterators.
+template<typename T>
+class TYPE_DEFAULT_VISIBILITY compressed_column
+{
+  static_assert(std::is_unsigned<T>::value, "Differences are encoded as unsigned varints");
+
+public:
+  static constexpr std::ptrdiff_t block_size = 128;
+
+  struct TYPE_DEFAULT_VISIBILITY block_entry
+  {
+    T value;
+    std::size_t offset;
+  };
+
+private:
+  std::vector<unsigned char> bytes;
+  std::vector<block_entry> blocks;
+  std::ptrdiff_t count;
+  T last;
+
+public:
+  ALWAYS_INLINE_HIDDEN compressed_column() : count(0), last(0) {}
+
+  template<typename Range>
+  explicit compressed_column(Range x) : count(0), last(0) {
+    for_each(x, make_derefop([this](T y) { push_back(y); }));
+  }
+
+  INLINE void push_back(T x) {
+    assert(0 == count || !(x < last));
+    if (0 == count % block_size) blocks.push_back(block_entry{x, bytes.size()});
+    impl::encode_varint(bytes, x - last);
+    last = x;
+    ++count;
+  }
+
+  ALWAYS_INLINE_HIDDEN std::ptrdiff_t size() const { return count; }
+
+  ALWAYS_INLINE_HIDDEN std::size_t size_in_bytes() const { return bytes.size() + blocks.size() * sizeof(block_entry); }
+
+  ALWAYS_INLINE_HIDDEN std::vector<block_entry> const& index() const { return blocks; }
+
+  // Iterator to the first value of block b, in constant time.
+  INLINE compressed_column_iterator<T> block_begin(std::ptrdiff_t b) const {
+    unsigned char const* p = bytes.data() + blocks[b].offset;
+    return {{p, blocks[b].value - impl::decode_varint<T>(p).m0, b * block_size, this}};
+  }
+
+  // Iterator to the i-th value, decoding at most block_size - 1 values.
+  INLINE compressed_column_iterator<T> iterator_at(std::ptrdiff_t i) const {
+    return range2::advance(block_begin(i / block_size), i % block_size);
+  }
+
+  ALWAYS_INLINE_HIDDEN Range<compressed_column_iterator<T>, Present, Present> range() const {
+    return make_range(compressed_column_iterator<T>{{bytes.data(), 0, 0, this}},
+                      compressed_column_iterator<T>{{bytes.data() + bytes.size(), last, count, this}},
+                      count);
+  }
+};
+
+// Partition point of a range over a compressed_column: bisects the block index, then scans the
+// one block that can hold the partition point. Found by ADL from partition_point and the bounds
+// functions built on it.
+template<typename T, typename End, typename Pred>
+INLINE pair<Range<compressed_column_iterator<T>, Present, Present>, Range<compressed_column_iterator<T>, End, Present>>
+partition_point_impl(Range<compressed_column_iterator<T>, End, Present> r, Pred pred) {
+  typedef std::ptrdiff_t D;
+  compressed_column<T> const& column = *get_begin(r).basis.column;
+  D const first = get_begin(r).basis.index;
+  D const limit = first + get_count(r);
+  D const B = compressed_column<T>::block_size;
+
+  // Block starts strictly inside the range
+  D lo = first / B + 1;
+  D hi = (limit + B - 1) / B;
+  if (hi < lo) hi = lo;
+  while (lo != hi) {
+    D mid = lo + (hi - lo) / 2;
+    if (pred(column.block_begin(mid))) hi = mid; else lo = mid + 1;
+  }
+  // The partition point lies between the start of the previous block and block lo
+  D scanFirst = (lo - 1) * B < first ? first : (lo - 1) * B;
+  D scanLimit = lo * B < limit ? lo * B : limit;
+  auto start = (scanFirst == first) ? get_begin(r) : column.block_begin(lo - 1);
+  auto found = find_if_impl(make_range(start, NotPresent{}, scanLimit - scanFirst), pred);
+  D lhsN = scanFirst - first + (scanLimit - scanFirst - get_count(found));
+  return range2::make_pair(make_range(get_begin(r), get_begin(found), lhsN), make_range(get_begin(found), get_end(r), get_count(r) - lhsN));
+}
+
+} // namespace range2
+
+#endif
@@ -0,0 +1 @@
+#include "contiguous.h"
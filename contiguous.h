@@ -0,0 +1,149 @@
+#ifndef INCLUDED_CONTIGUOUS
+#define INCLUDED_CONTIGUOUS
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_TYPE_TRAITS
+#define INCLUDED_TYPE_TRAITS
+#include <type_traits>
+#endif
+
+#ifndef INCLUDED_UTILITY
+#define INCLUDED_UTILITY
+#include <utility>
+#endif
+
+namespace range2 {
+
+// Iterators over elements adjacent in memory, which the algorithms may replace by pointers.
+// Pointers, and so std::array iterators, are contiguous; std::vector and std::basic_string
+// iterators are recognised for libstdc++; iterator<iterator_basis<I>> is if I is.
+template<typename I>
+struct TYPE_HIDDEN_VISIBILITY IsContiguousIterator : std::false_type {};
+
+template<typename T>
+struct TYPE_HIDDEN_VISIBILITY IsContiguousIterator<T*> : std::true_type {};
+
+template<typename T>
+constexpr ALWAYS_INLINE_HIDDEN T* to_address(T* x) {
+  return x;
+}
+
+#ifdef __GLIBCXX__
+template<typename T, typename Container>
+struct TYPE_HIDDEN_VISIBILITY IsContiguousIterator<__gnu_cxx::__normal_iterator<T*, Container>> : std::true_type {};
+
+template<typename T, typename Container>
+constexpr ALWAYS_INLINE_HIDDEN T* to_address(__gnu_cxx::__normal_iterator<T*, Container> const& x) {
+  return x.base();
+}
+#endif
+
+template<typename I>
+struct TYPE_HIDDEN_VISIBILITY IsContiguousIterator<iterator<iterator_basis<I>>> : IsContiguousIterator<I> {};
+
+template<typename I>
+constexpr ALWAYS_INLINE_HIDDEN auto to_address(iterator<iterator_basis<I>> const& x) -> decltype( to_address(state(x)) ) {
+  return to_address(state(x));
+}
+
+template<typename I>
+using ContiguousPointer = typename std::remove_reference<Reference<I>>::type*;
+
+namespace impl {
+
+template<typename Op, typename... Args>
+auto is_callable_with(int) -> decltype( std::declval<Op&>()(std::declval<Args>()...), std::true_type{} );
+
+template<typename Op, typename... Args>
+std::false_type is_callable_with(...);
+
+} // namespace impl
+
+template<typename Op, typename... Args>
+struct TYPE_HIDDEN_VISIBILITY IsCallableWith : decltype( impl::is_callable_with<Op, Args...>(0) ) {};
+
+// Counted ranges of contiguous iterators other than pointers, whose loops are lowered to pointers.
+template<typename T>
+struct TYPE_HIDDEN_VISIBILITY IsLowerable : std::false_type {};
+
+template<typename Iterator, typename End>
+struct TYPE_HIDDEN_VISIBILITY IsLowerable<Range<Iterator, End, Present>> :
+  std::integral_constant<bool, IsContiguousIterator<Iterator>::value && !std::is_pointer<Iterator>::value> {};
+
+namespace impl {
+
+template<typename Iterator, typename End>
+ALWAYS_INLINE_HIDDEN typename std::enable_if<IsLowerable<Range<Iterator, End, Present>>::value, Range<ContiguousPointer<Iterator>, NotPresent, Present>>::type
+lower(Range<Iterator, End, Present> const& x) {
+  return make_range(to_address(get_begin(x)), NotPresent{}, get_count(x));
+}
+
+template<typename Rng>
+ALWAYS_INLINE_HIDDEN typename std::enable_if<!IsLowerable<Rng>::value, Rng>::type
+lower(Rng const& x) {
+  return x;
+}
+
+template<typename Rng>
+using Lowered = decltype( lower(std::declval<Rng const&>()) );
+
+// Whether a loop over Rng0, passing Op iterators of Rng0 and any Rngs, may be given pointers
+// instead: Op must accept them too.
+template<typename Op, typename Rng0, typename... Rngs>
+struct TYPE_HIDDEN_VISIBILITY CanLower :
+  std::integral_constant<bool, IsLowerable<Rng0>::value &&
+                               IsCallableWith<Op, RangeIterator<Lowered<Rng0>> const&, RangeIterator<Lowered<Rngs>> const&...>::value> {};
+
+// Position in the original iterator type of p, given that anchor and p address the same sequence.
+template<typename Iterator, typename T>
+ALWAYS_INLINE_HIDDEN Iterator lift(Iterator const& anchor, T* p) {
+  return anchor + (p - to_address(anchor));
+}
+
+template<typename Iterator, typename T>
+ALWAYS_INLINE_HIDDEN NotPresent lift_end(Iterator const&, T*, NotPresent) {
+  return {};
+}
+
+template<typename Iterator, typename T>
+ALWAYS_INLINE_HIDDEN Iterator lift_end(Iterator const& anchor, T* p, Present) {
+  return lift(anchor, p);
+}
+
+template<typename Difference>
+ALWAYS_INLINE_HIDDEN NotPresent lift_count(Difference, NotPresent) {
+  return {};
+}
+
+template<typename Difference>
+ALWAYS_INLINE_HIDDEN Difference lift_count(Difference n, Present) {
+  return n;
+}
+
+template<typename Target>
+struct TYPE_HIDDEN_VISIBILITY lift_range;
+
+// Rebuilds in the Target shape a range of pointers into the sequence anchor addresses.
+template<typename Iterator, typename End, typename Count>
+struct TYPE_HIDDEN_VISIBILITY lift_range<Range<Iterator, End, Count>>
+{
+  template<typename T, typename End2>
+  static ALWAYS_INLINE_HIDDEN Range<Iterator, End, Count> apply(Iterator const& anchor, Range<T*, End2, Present> const& x) {
+    return Range<Iterator, End, Count>::make(lift(anchor, get_begin(x)), lift_end(anchor, get_begin(x) + get_count(x), End{}),
+                                             lift_count(get_count(x), Count{}));
+  }
+
+  // Not lowered
+  static ALWAYS_INLINE_HIDDEN Range<Iterator, End, Count> apply(Iterator const&, Range<Iterator, End, Count> const& x) {
+    return x;
+  }
+};
+
+} // namespace impl
+
+} // namespace range2
+
+#endif
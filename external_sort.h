@@ -0,0 +1,215 @@
+#ifndef INCLUDED_EXTERNAL_SORT
+#define INCLUDED_EXTERNAL_SORT
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHMS
+#include "algorithms.h"
+#endif
+
+#ifndef INCLUDED_RECORD_STREAM
+#include "record_stream.h"
+#endif
+
+#ifndef INCLUDED_ARENA
+#include "arena.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHM
+#define INCLUDED_ALGORITHM
+#include <algorithm>
+#endif
+
+#ifndef INCLUDED_CERRNO
+#define INCLUDED_CERRNO
+#include <cerrno>
+#endif
+
+#ifndef INCLUDED_CSTDIO
+#define INCLUDED_CSTDIO
+#include <cstdio>
+#endif
+
+#ifndef INCLUDED_NEW
+#define INCLUDED_NEW
+#include <new>
+#endif
+
+#ifndef INCLUDED_VECTOR
+#define INCLUDED_VECTOR
+#include <vector>
+#endif
+
+#ifndef INCLUDED_CSTDLIB
+#define INCLUDED_CSTDLIB
+#include <cstdlib>
+#endif
+
+#ifndef INCLUDED_UNISTD
+#define INCLUDED_UNISTD
+#include <unistd.h>
+#endif
+
+namespace range2 {
+
+struct TYPE_DEFAULT_VISIBILITY external_sort_options
+{
+  // Upper bound on the records held in memory, both while forming runs and while merging them.
+  std::size_t memory_budget_in_bytes;
+  // Directory in which the temporary run files are created.
+  char const* run_directory;
+};
+
+namespace impl {
+
+// Creates an anonymous temporary file; it is unlinked at once so it disappears when closed.
+// The path is formed on the stack, so creating a run does not allocate.
+INLINE int make_run_file(char const* directory, int& err) {
+  char path[4096];
+  int length = std::snprintf(path, sizeof(path), "%s/range2_runXXXXXX", directory);
+  if (length < 0 || std::size_t(length) >= sizeof(path)) {
+    err = ENAMETOOLONG;
+    return -1;
+  }
+  int fd = mkstemp(path);
+  if (-1 == fd) {
+    err = errno;
+    return fd;
+  }
+  unlink(path);
+  return fd;
+}
+
+INLINE int write_all(int fd, char const* buffer, std::size_t length) {
+  while (0 != length) {
+    ssize_t n = ::write(fd, buffer, length);
+    if (n < 0) {
+      if (EINTR == errno) continue;
+      return errno;
+    }
+    buffer += n, length -= std::size_t(n);
+  }
+  return 0;
+}
+
+template<typename Rel>
+struct TYPE_HIDDEN_VISIBILITY value_relation
+{
+  Rel rel;
+
+  // Relations take iterators; a pointer to the value is one.
+  template<typename T>
+  ALWAYS_INLINE_HIDDEN bool operator()(T const& x, T const& y) { return rel(&x, &y); }
+};
+
+template<typename Rel>
+struct TYPE_HIDDEN_VISIBILITY greater_front
+{
+  Rel rel;
+
+  template<typename Stream>
+  ALWAYS_INLINE_HIDDEN bool operator()(Stream const& x, Stream const& y) { return rel(&y->front(), &x->front()); }
+};
+
+} // namespace impl
+
+// Sorts the records of in, which may be a single pass range larger than memory, into out.
+// Sorted runs of at most memory_budget_in_bytes are written to temporary files in
+// run_directory and then k-way merged; input fitting within the budget is sorted in memory.
+// rel is a strict weak ordering taking iterators, as elsewhere in the library.
+// All working memory is taken from scratch and rewound before returning, so repeated sorts
+// with the same scratch do no heap allocation once it has grown: the run buffer, the list of
+// run files, and for the merge the record streams, their heap and their buffers, which are
+// carved from the run buffer as it is no longer needed.
+// Returns 0 or the errno value of the failing file operation, and the unwritten part of out.
+template<typename InRange, typename OutRange, typename Rel>
+INLINE pair<int, OutRange>
+external_sort_impl(InRange in, OutRange out, Rel rel, external_sort_options options, arena& scratch) {
+  typedef RangeValue<InRange> T;
+  static_assert(std::is_trivially_copyable<T>::value, "Records are written to and read from run files");
+
+  std::size_t chunk = options.memory_budget_in_bytes / sizeof(T);
+  if (0 == chunk) chunk = 1;
+  auto start = scratch.mark();
+  T* buffer = scratch.allocate_array<T>(chunk);
+  auto value_rel = impl::value_relation<Rel>{rel};
+
+  std::vector<int, arena_allocator<int>> runs{arena_allocator<int>(scratch)};
+  int err = 0;
+  while (!is_empty(in) && 0 == err) {
+    auto filled = visit_2_ranges(in, make_range(buffer, NotPresent{}, std::ptrdiff_t(chunk)), copy_step{});
+    in = filled.m0;
+    T* last = get_begin(filled.m1);
+    std::sort(buffer, last, value_rel);
+
+    if (runs.empty() && is_empty(in)) {
+      // Everything fitted in memory
+      auto tmp = visit_2_ranges(make_range(buffer, last, NotPresent{}), out, copy_step{});
+      scratch.rewind(start);
+      return range2::make_pair(0, tmp.m1);
+    }
+    int fd = impl::make_run_file(options.run_directory, err);
+    if (-1 == fd) break;
+    runs.push_back(fd);
+    err = impl::write_all(fd, reinterpret_cast<char const*>(buffer), std::size_t(last - buffer) * sizeof(T));
+  }
+
+  if (0 == err && !runs.empty()) {
+    // The merge divides the budget between the run buffers.
+    std::size_t const k = runs.size();
+    std::size_t perRun = options.memory_budget_in_bytes / (k * sizeof(T));
+    if (0 == perRun) perRun = 1;
+    T* buffers = (k * perRun <= chunk) ? buffer : scratch.allocate_array<T>(k * perRun);
+
+    record_stream<T>* streams = scratch.allocate_array<record_stream<T>>(k);
+    record_stream<T>** heap = scratch.allocate_array<record_stream<T>*>(k);
+    record_stream<T>** heap_end = heap;
+    std::size_t opened = 0;
+    for (; opened != k; ++opened) {
+      if (0 != lseek(runs[opened], 0, SEEK_SET)) {
+        err = errno;
+        break;
+      }
+      record_stream<T>* s = ::new (static_cast<void*>(streams + opened)) record_stream<T>(runs[opened], buffers + opened * perRun, perRun);
+      if (!s->empty()) *heap_end++ = s;
+    }
+    auto heap_rel = impl::greater_front<Rel>{rel};
+    std::make_heap(heap, heap_end, heap_rel);
+    while (0 == err && heap != heap_end && !is_empty(out)) {
+      std::pop_heap(heap, heap_end, heap_rel);
+      record_stream<T>* smallest = heap_end[-1];
+      sink(get_begin(out), smallest->front());
+      out = successor(out);
+      smallest->pop();
+      if (smallest->empty()) {
+        err = smallest->error();
+        --heap_end;
+      } else {
+        std::push_heap(heap, heap_end, heap_rel);
+      }
+    }
+    // The arena runs no destructors.
+    for (std::size_t i = 0; i != opened; ++i) streams[i].~record_stream<T>();
+  }
+  for (int fd : runs) ::close(fd);
+  scratch.rewind(start);
+  return range2::make_pair(err, out);
+}
+
+template<typename InRange, typename OutRange, typename Rel>
+ALWAYS_INLINE_HIDDEN auto external_sort(InRange in, OutRange out, Rel rel, external_sort_options options, arena& scratch) -> decltype( external_sort_impl(add_constant_time_count(in), add_constant_time_count(out), rel, options, scratch) ) {
+  static_assert(IsAFiniteRange<InRange>::value, "Must be a finite range");
+  return external_sort_impl(add_constant_time_count(in), add_constant_time_count(out), rel, options, scratch);
+}
+
+template<typename InRange, typename OutRange, typename Rel>
+ALWAYS_INLINE_HIDDEN auto external_sort(InRange in, OutRange out, Rel rel, external_sort_options options) -> decltype( external_sort_impl(add_constant_time_count(in), add_constant_time_count(out), rel, options, std::declval<arena&>()) ) {
+  arena scratch;
+  return external_sort(in, out, rel, options, scratch);
+}
+
+} // namespace range2
+
+#endif
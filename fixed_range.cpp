@@ -0,0 +1 @@
+#include "fixed_range.h"
@@ -0,0 +1,183 @@
+#ifndef INCLUDED_FIXED_RANGE
+#define INCLUDED_FIXED_RANGE
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHMS
+#include "algorithms.h"
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+namespace range2 {
+
+// A count known at compile time, held in the Count slot of a Range in place of Present.
+template<std::ptrdiff_t N>
+using FixedCount = std::integral_constant<std::ptrdiff_t, N>;
+
+// Range of exactly N elements, e.g. a block of SIMD lanes or the fields of a key. Only the
+// iterator is stored; successor and split_at change the type rather than a count, so the
+// algorithms below recurse on N and are fully unrolled, and constexpr where the iterator and
+// operations are.
+template<typename Iterator, std::ptrdiff_t N>
+struct TYPE_DEFAULT_VISIBILITY Range<Iterator, NotPresent, FixedCount<N>>
+{
+    static_assert(N >= 0, "A fixed count cannot be negative");
+
+    typedef Range type;
+    Iterator begin;
+
+    static constexpr ALWAYS_INLINE_HIDDEN
+    type make(Iterator begin, NotPresent, FixedCount<N>) {
+        return {cmove(begin)};
+    }
+
+    friend constexpr ALWAYS_INLINE_HIDDEN
+    bool empty_impl(type const&) { return 0 == N; }
+
+    friend constexpr ALWAYS_INLINE_HIDDEN
+    bool operator==(type const& x, type const& y) { return x.begin == y.begin; }
+};
+
+template<typename Iterator, std::ptrdiff_t N>
+using FixedRange = Range<Iterator, NotPresent, FixedCount<N>>;
+
+template<std::ptrdiff_t N, typename Iterator>
+constexpr ALWAYS_INLINE_HIDDEN FixedRange<Iterator, N> make_fixed_range(Iterator begin) {
+  return FixedRange<Iterator, N>::make(cmove(begin), NotPresent{}, FixedCount<N>{});
+}
+
+template<typename Iterator, std::ptrdiff_t N>
+constexpr ALWAYS_INLINE_HIDDEN FixedCount<N>
+get_count(FixedRange<Iterator, N> const&) {
+  return {};
+}
+
+template<typename Iterator, std::ptrdiff_t N>
+constexpr ALWAYS_INLINE_HIDDEN FixedRange<Iterator, N - 1>
+successor(FixedRange<Iterator, N> const& x) {
+  static_assert(N > 0, "Cannot take the successor of an empty range");
+  return make_fixed_range<N - 1>(range2::advance(get_begin(x), 1));
+}
+
+template<std::ptrdiff_t K, typename Iterator, std::ptrdiff_t N>
+constexpr ALWAYS_INLINE_HIDDEN pair<FixedRange<Iterator, K>, FixedRange<Iterator, N - K>>
+split_at(FixedRange<Iterator, N> const& x) {
+  static_assert(0 <= K && K <= N, "Split point must lie within the range");
+  return range2::make_pair(make_fixed_range<K>(get_begin(x)), make_fixed_range<N - K>(range2::advance(get_begin(x), K)));
+}
+
+template<typename Iterator, std::ptrdiff_t N>
+constexpr ALWAYS_INLINE_HIDDEN pair<FixedRange<Iterator, N / 2>, FixedRange<Iterator, N - N / 2>>
+splitInTwo(FixedRange<Iterator, N> const& x) {
+  return split_at<N / 2>(x);
+}
+
+// Variable length form for the algorithms without a fixed length overload.
+template<typename Iterator, std::ptrdiff_t N>
+constexpr ALWAYS_INLINE_HIDDEN Range<Iterator, NotPresent, Present>
+add_dynamic_count(FixedRange<Iterator, N> const& x) {
+  return make_range(get_begin(x), NotPresent{}, DifferenceType<Iterator>(N));
+}
+
+
+template<typename Iterator, std::ptrdiff_t N, typename Op>
+ALWAYS_INLINE_HIDDEN pair<Op, FixedRange<Iterator, 0>>
+for_each(FixedRange<Iterator, N> r, Op op) {
+  auto end = impl::unrolled_steps<N>::apply(get_begin(r), op);
+  return range2::make_pair(cmove(op), make_fixed_range<0>(cmove(end)));
+}
+
+namespace impl {
+
+template<std::ptrdiff_t N>
+struct TYPE_HIDDEN_VISIBILITY fixed_reduce
+{
+  template<typename Iterator, typename Op, typename Func, typename State>
+  static constexpr ALWAYS_INLINE_HIDDEN State apply(FixedRange<Iterator, N> const& x, Op op, Func f, State const& state) {
+    return fixed_reduce<N - 1>::apply(successor(x), op, f, op(state, f(get_begin(x))));
+  }
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY fixed_reduce<0>
+{
+  template<typename Iterator, typename Op, typename Func, typename State>
+  static constexpr ALWAYS_INLINE_HIDDEN State apply(FixedRange<Iterator, 0> const&, Op, Func, State const& state) {
+    return state;
+  }
+};
+
+template<std::ptrdiff_t N, std::ptrdiff_t M>
+struct TYPE_HIDDEN_VISIBILITY fixed_lexicographical_compare
+{
+  template<typename Iterator0, typename Iterator1, typename Rel>
+  static constexpr ALWAYS_INLINE_HIDDEN bool apply(FixedRange<Iterator0, N> const& x, FixedRange<Iterator1, M> const& y, Rel rel) {
+    return rel(get_begin(x), get_begin(y)) ||
+      (!rel(get_begin(y), get_begin(x)) && fixed_lexicographical_compare<N - 1, M - 1>::apply(successor(x), successor(y), rel));
+  }
+};
+
+template<std::ptrdiff_t M>
+struct TYPE_HIDDEN_VISIBILITY fixed_lexicographical_compare<0, M>
+{
+  template<typename Iterator0, typename Iterator1, typename Rel>
+  static constexpr ALWAYS_INLINE_HIDDEN bool apply(FixedRange<Iterator0, 0> const&, FixedRange<Iterator1, M> const&, Rel) {
+    return 0 != M;
+  }
+};
+
+template<std::ptrdiff_t N>
+struct TYPE_HIDDEN_VISIBILITY fixed_lexicographical_compare<N, 0>
+{
+  template<typename Iterator0, typename Iterator1, typename Rel>
+  static constexpr ALWAYS_INLINE_HIDDEN bool apply(FixedRange<Iterator0, N> const&, FixedRange<Iterator1, 0> const&, Rel) {
+    return false;
+  }
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY fixed_lexicographical_compare<0, 0>
+{
+  template<typename Iterator0, typename Iterator1, typename Rel>
+  static constexpr ALWAYS_INLINE_HIDDEN bool apply(FixedRange<Iterator0, 0> const&, FixedRange<Iterator1, 0> const&, Rel) {
+    return false;
+  }
+};
+
+} // namespace impl
+
+template<typename Iterator, std::ptrdiff_t N, typename Op, typename Func>
+constexpr ALWAYS_INLINE_HIDDEN pair<ValueType<Iterator>, FixedRange<Iterator, 0>>
+reduce_nonempty(FixedRange<Iterator, N> r, Op op, Func f) {
+  static_assert(N > 0, "Must be a non-empty range");
+  return range2::make_pair(impl::fixed_reduce<N - 1>::apply(successor(r), op, f, ValueType<Iterator>(deref(get_begin(r)))),
+                           make_fixed_range<0>(range2::advance(get_begin(r), N)));
+}
+
+template<typename Iterator, std::ptrdiff_t N, typename Op, typename Func>
+constexpr ALWAYS_INLINE_HIDDEN pair<ValueType<Iterator>, FixedRange<Iterator, 0>>
+reduce(FixedRange<Iterator, N> r, Op op, Func f, ValueType<Iterator> const&) {
+  return reduce_nonempty(r, op, f);
+}
+
+template<typename Iterator, typename Op, typename Func>
+constexpr ALWAYS_INLINE_HIDDEN pair<ValueType<Iterator>, FixedRange<Iterator, 0>>
+reduce(FixedRange<Iterator, 0> r, Op, Func, ValueType<Iterator> const& z) {
+  return range2::make_pair(z, r);
+}
+
+template<typename Iterator0, std::ptrdiff_t N, typename Iterator1, std::ptrdiff_t M, typename Rel>
+constexpr ALWAYS_INLINE_HIDDEN bool
+lexicographical_compare(FixedRange<Iterator0, N> r0, FixedRange<Iterator1, M> r1, Rel rel) {
+  return impl::fixed_lexicographical_compare<N, M>::apply(r0, r1, rel);
+}
+
+} // namespace range2
+
+#endif
@@ -11,6 +11,11 @@
 #include <type_traits>
 #endif
 
+#ifndef INCLUDED_CSTDINT
+#define INCLUDED_CSTDINT
+#include <cstdint>
+#endif
+
 #ifndef INCLUDED_COMPILER_SPECIFICS
 #include "compiler_specifics.h"
 #endif
@@ -82,6 +87,13 @@ I advance(I x, DifferenceType<I> n, std::input_iterator_tag) {
   return forwardByN(x, n);
 }
 
+template<typename I>
+ALWAYS_INLINE_HIDDEN
+I advance(I x, DifferenceType<I> n, std::output_iterator_tag) {
+  // n >= 0
+  return forwardByN(x, n);
+}
+
 template<BidirectionalIterator I>
 ALWAYS_INLINE_HIDDEN
 I advance(I x, DifferenceType<I> n, std::bidirectional_iterator_tag) {
@@ -379,6 +391,70 @@ ALWAYS_INLINE_HIDDEN auto sink(skip_iterator_basis<I, N> const& x, T&&... y) ->
   return sink(state(x), std::forward<T>(y)...);
 }
 
+namespace impl {
+
+// Only the address of a strided pointee can be formed without dereferencing (which could
+// touch beyond the end of the underlying sequence), so other iterators are not prefetched.
+template<InputIterator I>
+ALWAYS_INLINE_HIDDEN void prefetch_strided(I const&, DifferenceType<I>, std::false_type) {}
+
+template<typename T>
+ALWAYS_INLINE_HIDDEN void prefetch_strided(T* x, std::ptrdiff_t stride, std::true_type) {
+  // A stride within a cache line is handled by the hardware prefetcher.
+  if (stride * std::ptrdiff_t(sizeof(T)) >= CACHE_LINE_SIZE) {
+    // Integer arithmetic as the address may lie beyond the end of the array.
+    PREFETCH_READ(reinterpret_cast<void const*>(reinterpret_cast<std::uintptr_t>(x) + stride * sizeof(T)));
+  }
+}
+
+} // namespace impl
+
+// As skip_iterator_basis but with the stride only known at runtime.
+template <InputIterator I>
+struct TYPE_DEFAULT_VISIBILITY runtime_skip_iterator_basis {
+  typedef I state_type;
+  state_type position;
+  typedef ValueType<I> value_type;
+  typedef Reference<I> reference;
+  typedef Pointer<I> pointer;
+  typedef DifferenceType<I> difference_type;
+  typedef IteratorCategory<I> iterator_category;
+  difference_type stride;
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  reference deref(runtime_skip_iterator_basis const& x) { return deref(x.position); }
+
+  friend ALWAYS_INLINE_HIDDEN
+  runtime_skip_iterator_basis successor(runtime_skip_iterator_basis const& x) {
+    runtime_skip_iterator_basis tmp = {range2::advance(x.position, x.stride), x.stride};
+    impl::prefetch_strided(tmp.position, tmp.stride, std::is_pointer<I>{});
+    return tmp;
+  }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  runtime_skip_iterator_basis predecessor(runtime_skip_iterator_basis const& x) { return {range2::advance(x.position, -x.stride), x.stride}; }
+
+  // for random access iterator
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  runtime_skip_iterator_basis offset(runtime_skip_iterator_basis const& x, difference_type i) { return {x.position + i * x.stride, x.stride}; }
+
+  // Precondition x.stride == y.stride
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  difference_type difference(runtime_skip_iterator_basis const& x, runtime_skip_iterator_basis const& y) { return std::distance(y.position, x.position) / x.stride; }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  state_type state(runtime_skip_iterator_basis const& x) { return x.position; }
+};
+
+
+template<InputIterator I>
+struct TYPE_HIDDEN_VISIBILITY AutomaticallyGenerateSink<runtime_skip_iterator_basis<I>> : std::false_type {};
+
+template<typename... T, InputIterator I>
+ALWAYS_INLINE_HIDDEN auto sink(runtime_skip_iterator_basis<I> const& x, T&&... y) -> decltype( sink(state(x), std::forward<T>(y)...) ) {
+  return sink(state(x), std::forward<T>(y)...);
+}
+
 template<InputIterator I>
 struct TYPE_HIDDEN_VISIBILITY iterator_impl {
   typedef iterator<iterator_basis<I>> type;
@@ -431,15 +507,38 @@ constexpr ALWAYS_INLINE_HIDDEN reverse_iterator<I> make_reverse_iterator(I x) {
   return reverse_iterator_impl<I>::apply(x);
 }
 
-template<InputIterator I, DifferenceType<I> N>
-struct TYPE_HIDDEN_VISIBILITY skip_iterator_impl {
-  typedef iterator<skip_iterator_basis<I, N>> type;
+// For the function skip_iterator we can't get the DifferenceType before knowing the iterator
+// but then this would mean callers have to specify 
+typedef long long SkipIteratorStride;
+
+namespace impl {
+
+// The stride of skip_iterator_impl's primary template has a type depending on the iterator, so
+// a partial specialization for another iterator type would not be more specialized than it.
+// Iterators striding at run time are picked out here instead, with a stride of fixed type.
+template<InputIterator I, SkipIteratorStride N>
+struct TYPE_HIDDEN_VISIBILITY skip_iterator_stride {
+  typedef iterator<skip_iterator_basis<I, DifferenceType<I>(N)>> type;
 
   static constexpr ALWAYS_INLINE_HIDDEN type apply(I x) {
     return {{x}};
   }
 };
 
+template<InputIterator I, SkipIteratorStride N>
+struct TYPE_HIDDEN_VISIBILITY skip_iterator_stride<iterator<runtime_skip_iterator_basis<I>>, N> {
+  typedef iterator<runtime_skip_iterator_basis<I>> type;
+
+  static constexpr ALWAYS_INLINE_HIDDEN type apply(iterator<runtime_skip_iterator_basis<I>> x) {
+    return {{state(x), x.basis.stride * N}};
+  }
+};
+
+} // namespace impl
+
+template<InputIterator I, DifferenceType<I> N>
+struct TYPE_HIDDEN_VISIBILITY skip_iterator_impl : impl::skip_iterator_stride<I, N> {};
+
 template<InputIterator I, DifferenceType<I> N, DifferenceType<I> M>
 struct TYPE_HIDDEN_VISIBILITY skip_iterator_impl<iterator<skip_iterator_basis<I, M>>, N> {
   typedef typename skip_iterator_impl<I, N * M>::type type;
@@ -461,15 +560,56 @@ struct TYPE_HIDDEN_VISIBILITY skip_iterator_impl<iterator<reverse_iterator_basis
 template<InputIterator I, DifferenceType<I> N>
 using skip_iterator = typename skip_iterator_impl<I, N>::type;
 
-// For the function skip_iterator we can't get the DifferenceType before knowing the iterator
-// but then this would mean callers have to specify 
-typedef long long SkipIteratorStride;
-
 template<SkipIteratorStride N, InputIterator I>
 constexpr ALWAYS_INLINE_HIDDEN skip_iterator<I, N> make_skip_iterator(I x) {
   return skip_iterator_impl<I, N>::apply(x);
 }
 
+template<InputIterator I>
+struct TYPE_HIDDEN_VISIBILITY runtime_skip_iterator_impl {
+  typedef iterator<runtime_skip_iterator_basis<I>> type;
+
+  static constexpr ALWAYS_INLINE_HIDDEN type apply(I x, DifferenceType<I> n) {
+    return {{x, n}};
+  }
+};
+
+template<InputIterator I>
+struct TYPE_HIDDEN_VISIBILITY runtime_skip_iterator_impl<iterator<runtime_skip_iterator_basis<I>>> {
+  typedef iterator<runtime_skip_iterator_basis<I>> type;
+
+  static constexpr ALWAYS_INLINE_HIDDEN type apply(iterator<runtime_skip_iterator_basis<I>> x, DifferenceType<I> n) {
+    return {{state(x), x.basis.stride * n}};
+  }
+};
+
+template<InputIterator I, DifferenceType<I> M>
+struct TYPE_HIDDEN_VISIBILITY runtime_skip_iterator_impl<iterator<skip_iterator_basis<I, M>>> {
+  typedef iterator<runtime_skip_iterator_basis<I>> type;
+
+  static constexpr ALWAYS_INLINE_HIDDEN type apply(iterator<skip_iterator_basis<I, M>> x, DifferenceType<I> n) {
+    return {{state(x), M * n}};
+  }
+};
+
+template<BidirectionalIterator I>
+struct TYPE_HIDDEN_VISIBILITY runtime_skip_iterator_impl<iterator<reverse_iterator_basis<I>>> {
+  typedef reverse_iterator<typename runtime_skip_iterator_impl<I>::type> type;
+
+  static constexpr ALWAYS_INLINE_HIDDEN type apply(iterator<reverse_iterator_basis<I>> x, DifferenceType<I> n) {
+    return make_reverse_iterator(runtime_skip_iterator_impl<I>::apply(state(x), n));
+  }
+};
+
+template<InputIterator I>
+using runtime_skip_iterator = typename runtime_skip_iterator_impl<I>::type;
+
+template<InputIterator I>
+constexpr ALWAYS_INLINE_HIDDEN runtime_skip_iterator<I> make_skip_iterator(I x, DifferenceType<I> n) {
+  // Precondition n > 0
+  return runtime_skip_iterator_impl<I>::apply(x, n);
+}
+
 } // namespace range2
 
 #endif
@@ -0,0 +1 @@
+#include "latency_histogram.h"
@@ -0,0 +1,106 @@
+#ifndef INCLUDED_LATENCY_HISTOGRAM
+#define INCLUDED_LATENCY_HISTOGRAM
+
+#ifndef INCLUDED_COMPILER_SPECIFICS
+#include "compiler_specifics.h"
+#endif
+
+#ifndef INCLUDED_CASSERT
+#define INCLUDED_CASSERT
+#include <cassert>
+#endif
+
+#ifndef INCLUDED_CSTDINT
+#define INCLUDED_CSTDINT
+#include <cstdint>
+#endif
+
+#ifndef INCLUDED_VECTOR
+#define INCLUDED_VECTOR
+#include <vector>
+#endif
+
+namespace range2 {
+
+// Histogram of non-negative integer latencies with bounded relative error, in the style of
+// HdrHistogram: values below 2^(sub_bucket_bits + 1) are counted exactly, larger ones in one of
+// 2^sub_bucket_bits equal width buckets within their power of two, so a reported value is
+// within 1/2^sub_bucket_bits of a recorded one. Recording is constant time and allocation free.
+class TYPE_DEFAULT_VISIBILITY latency_histogram
+{
+public:
+  static constexpr unsigned sub_bucket_bits = 5;
+
+private:
+  static constexpr unsigned sub_buckets = 1u << sub_bucket_bits;
+
+  std::vector<std::uint64_t> counts;
+  std::uint64_t total;
+  std::uint64_t min_;
+  std::uint64_t max_;
+  double sum;
+
+  static ALWAYS_INLINE_HIDDEN unsigned bit_length(std::uint64_t x) {
+    return (0 == x) ? 0 : 64 - __builtin_clzll(x);
+  }
+
+  static ALWAYS_INLINE_HIDDEN std::size_t bucket_index(std::uint64_t x) {
+    unsigned n = bit_length(x);
+    unsigned shift = (n > sub_bucket_bits + 1) ? n - (sub_bucket_bits + 1) : 0;
+    return (std::size_t(shift) << sub_bucket_bits) + (x >> shift);
+  }
+
+  // Largest value counted in bucket i.
+  static ALWAYS_INLINE_HIDDEN std::uint64_t highest_equivalent(std::size_t i) {
+    if (i < 2 * sub_buckets) return i;
+    unsigned shift = static_cast<unsigned>(i >> sub_bucket_bits) - 1;
+    std::uint64_t lowest = std::uint64_t(i - (std::size_t(shift) << sub_bucket_bits)) << shift;
+    return lowest + ((std::uint64_t(1) << shift) - 1);
+  }
+
+public:
+  INLINE latency_histogram()
+    : counts(bucket_index(~std::uint64_t(0)) + 1, 0), total(0), min_(~std::uint64_t(0)), max_(0), sum(0.0) {}
+
+  ALWAYS_INLINE_HIDDEN void record(std::uint64_t x) {
+    ++counts[bucket_index(x)];
+    ++total;
+    if (x < min_) min_ = x;
+    if (x > max_) max_ = x;
+    sum += double(x);
+  }
+
+  INLINE void clear() {
+    for (std::uint64_t& x : counts) x = 0;
+    total = 0, min_ = ~std::uint64_t(0), max_ = 0, sum = 0.0;
+  }
+
+  ALWAYS_INLINE_HIDDEN std::uint64_t count() const { return total; }
+
+  ALWAYS_INLINE_HIDDEN std::uint64_t min() const { return min_; }
+
+  ALWAYS_INLINE_HIDDEN std::uint64_t max() const { return max_; }
+
+  ALWAYS_INLINE_HIDDEN double mean() const { return sum / double(total); }
+
+  // Value at or below which percent of the recorded values lie, 0 <= percent <= 100.
+  // Precondition: 0 != count()
+  INLINE std::uint64_t percentile(double percent) const {
+    assert(0 != total);
+    std::uint64_t rank = static_cast<std::uint64_t>(percent / 100.0 * double(total) + 0.5);
+    if (rank < 1) rank = 1;
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i != counts.size(); ++i) {
+      seen += counts[i];
+      if (seen >= rank) {
+        std::uint64_t x = highest_equivalent(i);
+        return x < max_ ? x : max_;
+      }
+    }
+    return max_;
+  }
+};
+
+} // namespace range2
+
+#endif
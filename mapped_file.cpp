@@ -0,0 +1 @@
+#include "mapped_file.h"
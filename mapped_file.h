@@ -0,0 +1,269 @@
+#ifndef INCLUDED_MAPPED_FILE
+#define INCLUDED_MAPPED_FILE
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_CERRNO
+#define INCLUDED_CERRNO
+#include <cerrno>
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+#ifndef INCLUDED_CSTDINT
+#define INCLUDED_CSTDINT
+#include <cstdint>
+#endif
+
+#ifndef INCLUDED_FCNTL
+#define INCLUDED_FCNTL
+#include <fcntl.h>
+#endif
+
+#ifndef INCLUDED_SYS_MMAN
+#define INCLUDED_SYS_MMAN
+#include <sys/mman.h>
+#endif
+
+#ifndef INCLUDED_SYS_STAT
+#define INCLUDED_SYS_STAT
+#include <sys/stat.h>
+#endif
+
+#ifndef INCLUDED_UNISTD
+#define INCLUDED_UNISTD
+#include <unistd.h>
+#endif
+
+namespace range2 {
+
+// Access patterns passed to madvise.
+struct TYPE_DEFAULT_VISIBILITY NormalAccess { typedef NormalAccess type; static constexpr int advice = MADV_NORMAL; };
+struct TYPE_DEFAULT_VISIBILITY SequentialAccess { typedef SequentialAccess type; static constexpr int advice = MADV_SEQUENTIAL; };
+struct TYPE_DEFAULT_VISIBILITY RandomAccess { typedef RandomAccess type; static constexpr int advice = MADV_RANDOM; };
+struct TYPE_DEFAULT_VISIBILITY WillNeedAccess { typedef WillNeedAccess type; static constexpr int advice = MADV_WILLNEED; };
+
+// Tags naming the algorithm about to be run over a mapping, from which the access pattern is chosen.
+struct TYPE_HIDDEN_VISIBILITY ForEach { typedef ForEach type; };
+struct TYPE_HIDDEN_VISIBILITY FindIf { typedef FindIf type; };
+struct TYPE_HIDDEN_VISIBILITY CountIf { typedef CountIf type; };
+struct TYPE_HIDDEN_VISIBILITY Reduce { typedef Reduce type; };
+struct TYPE_HIDDEN_VISIBILITY BisectingSearch { typedef BisectingSearch type; };
+struct TYPE_HIDDEN_VISIBILITY PartitionPoint { typedef PartitionPoint type; };
+struct TYPE_HIDDEN_VISIBILITY EquivalentRange { typedef EquivalentRange type; };
+
+template<typename Algorithm>
+struct TYPE_HIDDEN_VISIBILITY AccessPattern : NormalAccess {};
+
+template<> struct TYPE_HIDDEN_VISIBILITY AccessPattern<ForEach> : SequentialAccess {};
+template<> struct TYPE_HIDDEN_VISIBILITY AccessPattern<FindIf> : SequentialAccess {};
+template<> struct TYPE_HIDDEN_VISIBILITY AccessPattern<CountIf> : SequentialAccess {};
+template<> struct TYPE_HIDDEN_VISIBILITY AccessPattern<Reduce> : SequentialAccess {};
+template<> struct TYPE_HIDDEN_VISIBILITY AccessPattern<BisectingSearch> : RandomAccess {};
+template<> struct TYPE_HIDDEN_VISIBILITY AccessPattern<PartitionPoint> : RandomAccess {};
+template<> struct TYPE_HIDDEN_VISIBILITY AccessPattern<EquivalentRange> : RandomAccess {};
+
+struct TYPE_DEFAULT_VISIBILITY map_options
+{
+  // Fault the whole file in up front (MAP_POPULATE).
+  bool populate;
+  // Ask for transparent huge pages; ignored where the filesystem cannot supply them.
+  bool huge_pages;
+};
+
+namespace impl {
+
+// Ownership of a mapping and the errno value of any failure to make it, shared by the mapped
+// file classes. Moving leaves the source closed.
+class TYPE_DEFAULT_VISIBILITY file_mapping
+{
+protected:
+  void* address;
+  std::size_t length;
+  int err;
+
+  ALWAYS_INLINE_HIDDEN file_mapping() : address(nullptr), length(0), err(EBADF) {}
+
+  ALWAYS_INLINE_HIDDEN file_mapping(std::size_t length, int err) : address(nullptr), length(length), err(err) {}
+
+  ALWAYS_INLINE_HIDDEN file_mapping(file_mapping&& x) : address(x.address), length(x.length), err(x.err) {
+    x.address = nullptr, x.length = 0, x.err = EBADF;
+  }
+
+  ALWAYS_INLINE_HIDDEN file_mapping& operator=(file_mapping&& x) {
+    if (this != &x) {
+      release();
+      address = x.address, length = x.length, err = x.err;
+      x.address = nullptr, x.length = 0, x.err = EBADF;
+    }
+    return *this;
+  }
+
+  file_mapping(file_mapping const&) = delete;
+  file_mapping& operator=(file_mapping const&) = delete;
+
+  ALWAYS_INLINE_HIDDEN ~file_mapping() { release(); }
+
+  ALWAYS_INLINE_HIDDEN void release() {
+    if (nullptr != address) munmap(address, length);
+    address = nullptr, length = 0;
+  }
+
+public:
+  ALWAYS_INLINE_HIDDEN bool is_open() const { return 0 == err; }
+
+  ALWAYS_INLINE_HIDDEN int error() const { return err; }
+
+  ALWAYS_INLINE_HIDDEN std::size_t size_in_bytes() const { return length; }
+};
+
+} // namespace impl
+
+// Read-only mapping of a file of fixed width records of type T.
+// Failure is reported through is_open() and error() (an errno value) rather than by exception.
+// A trailing partial record is not part of the range.
+template<typename T>
+class TYPE_DEFAULT_VISIBILITY mapped_file : private impl::file_mapping
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Records are read directly from the file");
+
+public:
+  using impl::file_mapping::is_open;
+  using impl::file_mapping::error;
+  using impl::file_mapping::size_in_bytes;
+
+  ALWAYS_INLINE_HIDDEN mapped_file() {}
+
+  explicit mapped_file(char const* path, map_options options = map_options{false, false}) : impl::file_mapping(0, 0) {
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (-1 == fd) {
+      err = errno;
+      return;
+    }
+    struct stat st;
+    if (-1 == fstat(fd, &st)) {
+      err = errno;
+    } else if (0 != st.st_size) {
+      // mmap rejects zero lengths, an empty file is represented without a mapping.
+      int flags = MAP_PRIVATE | (options.populate ? MAP_POPULATE : 0);
+      void* p = mmap(nullptr, std::size_t(st.st_size), PROT_READ, flags, fd, 0);
+      if (MAP_FAILED == p) {
+        err = errno;
+      } else {
+        address = p, length = std::size_t(st.st_size);
+#ifdef MADV_HUGEPAGE
+        if (options.huge_pages) madvise(address, length, MADV_HUGEPAGE);
+#endif
+      }
+    }
+    ::close(fd);
+  }
+
+  mapped_file(mapped_file&&) = default;
+  mapped_file& operator=(mapped_file&&) = default;
+
+  mapped_file(mapped_file const&) = delete;
+  mapped_file& operator=(mapped_file const&) = delete;
+
+  // Valid for the lifetime of the mapping.
+  ALWAYS_INLINE_HIDDEN Range<T const*, Present, Present> range() const {
+    T const* begin = static_cast<T const*>(address);
+    std::ptrdiff_t count = std::ptrdiff_t(length / sizeof(T));
+    return make_range(begin, begin + count, count);
+  }
+
+  // Returns 0 or an errno value.
+  template<typename Access>
+  ALWAYS_INLINE_HIDDEN int advise(Access) const {
+    if (nullptr == address) return 0;
+    return -1 == madvise(address, length, Access::advice) ? errno : 0;
+  }
+};
+
+// Writable shared mapping of a newly created file of count records of type T, preallocated so
+// that writes through the mapping cannot fail for lack of disk space. Any existing file is truncated.
+// Failure is reported through is_open() and error(), as for mapped_file.
+// Data reaches the file no later than unmapping; flush forces it there earlier.
+template<typename T>
+class TYPE_DEFAULT_VISIBILITY writable_mapped_file : private impl::file_mapping
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Records are written directly to the file");
+
+public:
+  using impl::file_mapping::is_open;
+  using impl::file_mapping::error;
+  using impl::file_mapping::size_in_bytes;
+
+  ALWAYS_INLINE_HIDDEN writable_mapped_file() {}
+
+  writable_mapped_file(char const* path, std::size_t count, map_options options = map_options{false, false}) : impl::file_mapping(count * sizeof(T), 0) {
+    int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (-1 == fd) {
+      err = errno, length = 0;
+      return;
+    }
+    if (0 != length) {
+      // posix_fallocate returns the error rather than setting errno.
+      err = posix_fallocate(fd, 0, off_t(length));
+      if (0 == err) {
+        int flags = MAP_SHARED | (options.populate ? MAP_POPULATE : 0);
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (MAP_FAILED == p) {
+          err = errno;
+        } else {
+          address = p;
+#ifdef MADV_HUGEPAGE
+          if (options.huge_pages) madvise(address, length, MADV_HUGEPAGE);
+#endif
+        }
+      }
+      if (0 != err) length = 0;
+    }
+    ::close(fd);
+  }
+
+  writable_mapped_file(writable_mapped_file&&) = default;
+  writable_mapped_file& operator=(writable_mapped_file&&) = default;
+
+  writable_mapped_file(writable_mapped_file const&) = delete;
+  writable_mapped_file& operator=(writable_mapped_file const&) = delete;
+
+  // Counted output Range over the whole file, valid for the lifetime of the mapping.
+  ALWAYS_INLINE_HIDDEN Range<T*, Present, Present> range() const {
+    T* begin = static_cast<T*>(address);
+    std::ptrdiff_t count = std::ptrdiff_t(length / sizeof(T));
+    return make_range(begin, begin + count, count);
+  }
+
+  // Writes the pages holding the records of x (a sub-range of range()) back to the file,
+  // waiting for completion unless asynchronous. Returns 0 or an errno value.
+  template<typename End, typename Count>
+  INLINE int flush(Range<T*, End, Count> const& x, bool asynchronous = false) const {
+    auto y = add_constant_time_end(add_constant_time_count(x));
+    if (is_empty(y)) return 0;
+    // msync requires a page aligned start address
+    std::uintptr_t page = std::uintptr_t(sysconf(_SC_PAGESIZE));
+    std::uintptr_t first = reinterpret_cast<std::uintptr_t>(get_begin(y)) / page * page;
+    std::uintptr_t last = reinterpret_cast<std::uintptr_t>(get_end(y));
+    return -1 == msync(reinterpret_cast<void*>(first), last - first, asynchronous ? MS_ASYNC : MS_SYNC) ? errno : 0;
+  }
+
+  ALWAYS_INLINE_HIDDEN int flush(bool asynchronous = false) const {
+    return flush(range(), asynchronous);
+  }
+};
+
+// Hint the kernel with the access pattern of the algorithm about to run over the mapping.
+template<typename Algorithm, typename T>
+ALWAYS_INLINE_HIDDEN int advise_for(mapped_file<T> const& x) {
+  return x.advise(AccessPattern<Algorithm>{});
+}
+
+} // namespace range2
+
+#endif
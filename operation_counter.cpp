@@ -0,0 +1 @@
+#include "operation_counter.h"
@@ -0,0 +1,170 @@
+#ifndef INCLUDED_OPERATION_COUNTER
+#define INCLUDED_OPERATION_COUNTER
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_CMATH
+#define INCLUDED_CMATH
+#include <cmath>
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+namespace range2 {
+
+// Tally of the primitive operations an algorithm performed through counting iterators and
+// relations sharing it.
+struct TYPE_DEFAULT_VISIBILITY operation_counts
+{
+  std::ptrdiff_t successors;
+  std::ptrdiff_t predecessors;
+  std::ptrdiff_t offsets;
+  std::ptrdiff_t differences;
+  std::ptrdiff_t derefs;
+  std::ptrdiff_t comparisons;
+
+  ALWAYS_INLINE_HIDDEN std::ptrdiff_t total() const {
+    return successors + predecessors + offsets + differences + derefs + comparisons;
+  }
+
+  // Iterator movements, the cost Complexity<Advance> and Complexity<AddEnd> describe.
+  ALWAYS_INLINE_HIDDEN std::ptrdiff_t traversals() const {
+    return successors + predecessors + offsets + differences;
+  }
+};
+
+// Iterator basis forwarding to I and counting each operation in *counts.
+template <InputIterator I>
+struct TYPE_DEFAULT_VISIBILITY counting_iterator_basis {
+  typedef I state_type;
+  state_type position;
+  typedef ValueType<I> value_type;
+  typedef Reference<I> reference;
+  typedef Pointer<I> pointer;
+  typedef DifferenceType<I> difference_type;
+  typedef IteratorCategory<I> iterator_category;
+  operation_counts* counts;
+
+  friend ALWAYS_INLINE_HIDDEN
+  reference deref(counting_iterator_basis const& x) { ++x.counts->derefs; return deref(x.position); }
+
+  friend ALWAYS_INLINE_HIDDEN
+  counting_iterator_basis successor(counting_iterator_basis const& x) { ++x.counts->successors; return {range2::successor(x.position), x.counts}; }
+
+  friend ALWAYS_INLINE_HIDDEN
+  counting_iterator_basis predecessor(counting_iterator_basis const& x) { ++x.counts->predecessors; return {range2::predecessor(x.position), x.counts}; }
+
+  friend ALWAYS_INLINE_HIDDEN
+  counting_iterator_basis offset(counting_iterator_basis const& x, difference_type i) { ++x.counts->offsets; return {x.position + i, x.counts}; }
+
+  friend ALWAYS_INLINE_HIDDEN
+  difference_type difference(counting_iterator_basis const& x, counting_iterator_basis const& y) { ++x.counts->differences; return std::distance(y.position, x.position); }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  state_type state(counting_iterator_basis const& x) { return x.position; }
+};
+
+template<InputIterator I>
+struct TYPE_HIDDEN_VISIBILITY AutomaticallyGenerateSink<counting_iterator_basis<I>> : std::false_type {};
+
+template<typename... T, InputIterator I>
+ALWAYS_INLINE_HIDDEN auto sink(counting_iterator_basis<I> const& x, T&&... y) -> decltype( sink(state(x), std::forward<T>(y)...) ) {
+  ++x.counts->derefs;
+  return sink(state(x), std::forward<T>(y)...);
+}
+
+template<InputIterator I>
+using counting_iterator = iterator<counting_iterator_basis<I>>;
+
+template<InputIterator I>
+ALWAYS_INLINE_HIDDEN counting_iterator<I> make_counting_iterator(I x, operation_counts* counts) {
+  return {{cmove(x), counts}};
+}
+
+namespace impl {
+
+template<InputIterator I>
+ALWAYS_INLINE_HIDDEN counting_iterator<I> make_counting_end(I x, operation_counts* counts) {
+  return make_counting_iterator(cmove(x), counts);
+}
+
+ALWAYS_INLINE_HIDDEN NotPresent make_counting_end(NotPresent x, operation_counts*) {
+  return x;
+}
+
+} // namespace impl
+
+// Range over the same elements as x whose iterators count their operations in *counts.
+template<typename Iterator, typename End, typename Count>
+ALWAYS_INLINE_HIDDEN auto make_counting_range(Range<Iterator, End, Count> const& x, operation_counts* counts)
+  -> decltype( make_range(make_counting_iterator(get_begin(x), counts), impl::make_counting_end(get_end(x), counts), get_count(x)) ) {
+  return make_range(make_counting_iterator(get_begin(x), counts), impl::make_counting_end(get_end(x), counts), get_count(x));
+}
+
+// Relation or predicate counting each application in *counts.
+template<typename Op>
+struct TYPE_HIDDEN_VISIBILITY counting_op
+{
+  Op op;
+  operation_counts* counts;
+
+  template<typename... T>
+  ALWAYS_INLINE_HIDDEN auto operator()(T&&... t) -> decltype( op(std::forward<T>(t)...) ) {
+    ++counts->comparisons;
+    return op(std::forward<T>(t)...);
+  }
+};
+
+template<typename Op>
+ALWAYS_INLINE_HIDDEN counting_op<Op> make_counting_op(Op op, operation_counts* counts) {
+  return {cmove(op), counts};
+}
+
+
+// Growth bound of each complexity class at size n, normalised so every bound is at least 1.
+template<typename C>
+struct TYPE_HIDDEN_VISIBILITY ComplexityBound;
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY ComplexityBound<ConstantComplexity> {
+  static ALWAYS_INLINE_HIDDEN double apply(double) { return 1.0; }
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY ComplexityBound<LogarithmicComplexity> {
+  static ALWAYS_INLINE_HIDDEN double apply(double n) { return 1.0 + std::log2(n); }
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY ComplexityBound<LinearComplexity> {
+  static ALWAYS_INLINE_HIDDEN double apply(double n) { return n; }
+};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY ComplexityBound<LogarithmicLinearComplexity> {
+  static ALWAYS_INLINE_HIDDEN double apply(double n) { return n * (1.0 + std::log2(n)); }
+};
+
+// Whether the operation counts op(n) returns grow no faster than complexity class C as n doubles
+// from smallest to largest: the counts must stay within a constant factor of the bound fitted at
+// the smallest size. A linear pass hiding in a constant or logarithmic operation exceeds it once
+// largest / smallest is large enough, 2^10 say.
+// Precondition: 0 < smallest && smallest <= largest
+template<typename C, typename Op>
+INLINE bool meets_complexity(Op op, std::ptrdiff_t smallest, std::ptrdiff_t largest) {
+  typedef ComplexityBound<typename C::type> Bound;
+  double const allowance = (1.0 + double(op(smallest))) / Bound::apply(double(smallest));
+  for (std::ptrdiff_t n = smallest; n <= largest; n *= 2) {
+    if (double(op(n)) > 2.0 * allowance * Bound::apply(double(n)) + 2.0) return false;
+  }
+  return true;
+}
+
+} // namespace range2
+
+#endif
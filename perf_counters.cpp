@@ -0,0 +1 @@
+#include "perf_counters.h"
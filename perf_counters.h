@@ -0,0 +1,169 @@
+#ifndef INCLUDED_PERF_COUNTERS
+#define INCLUDED_PERF_COUNTERS
+
+#ifndef INCLUDED_COMPILER_SPECIFICS
+#include "compiler_specifics.h"
+#endif
+
+#ifndef INCLUDED_CSTDINT
+#define INCLUDED_CSTDINT
+#include <cstdint>
+#endif
+
+#ifndef INCLUDED_CSTRING
+#define INCLUDED_CSTRING
+#include <cstring>
+#endif
+
+#ifdef __linux__
+#ifndef INCLUDED_LINUX_PERF_EVENT
+#define INCLUDED_LINUX_PERF_EVENT
+#include <linux/perf_event.h>
+#endif
+
+#ifndef INCLUDED_SYS_IOCTL
+#define INCLUDED_SYS_IOCTL
+#include <sys/ioctl.h>
+#endif
+
+#ifndef INCLUDED_SYS_SYSCALL
+#define INCLUDED_SYS_SYSCALL
+#include <sys/syscall.h>
+#endif
+
+#ifndef INCLUDED_UNISTD
+#define INCLUDED_UNISTD
+#include <unistd.h>
+#endif
+#endif
+
+namespace range2 {
+
+// Indices of the hardware events in perf_counts.
+namespace perf_event {
+enum { cycles, instructions, branch_misses, l1d_read_misses, llc_misses, dtlb_read_misses, size };
+}
+
+INLINE char const* perf_event_name(int event) {
+  static char const* const names[perf_event::size] = {
+    "cycles", "instructions", "branch misses", "L1D read misses", "LLC misses", "dTLB read misses"
+  };
+  return names[event];
+}
+
+// Event totals for a measured region; an event the kernel or hardware could not count is negative.
+struct TYPE_DEFAULT_VISIBILITY perf_counts
+{
+  double values[perf_event::size];
+
+  ALWAYS_INLINE_HIDDEN bool available(int event) const { return values[event] >= 0.0; }
+
+  ALWAYS_INLINE_HIDDEN double instructions_per_cycle() const {
+    return (available(perf_event::cycles) && available(perf_event::instructions) && 0.0 != values[perf_event::cycles])
+      ? values[perf_event::instructions] / values[perf_event::cycles] : -1.0;
+  }
+
+  friend ALWAYS_INLINE_HIDDEN perf_counts& operator+=(perf_counts& x, perf_counts const& y) {
+    for (int i = 0; i != perf_event::size; ++i) {
+      x.values[i] = (x.available(i) && y.available(i)) ? x.values[i] + y.values[i] : -1.0;
+    }
+    return x;
+  }
+};
+
+INLINE perf_counts make_zero_perf_counts() {
+  perf_counts tmp;
+  for (double& x : tmp.values) x = 0.0;
+  return tmp;
+}
+
+INLINE perf_counts make_unavailable_perf_counts() {
+  perf_counts tmp;
+  for (double& x : tmp.values) x = -1.0;
+  return tmp;
+}
+
+// Counts hardware events of the calling thread, in user space, between start and stop.
+// Events are opened independently so any the kernel refuses (perf_event_paranoid, no PMU in a
+// virtual machine, an unknown cache event) are reported unavailable and the rest still count.
+// When the kernel multiplexes counters the totals are scaled by the fraction of time counted.
+class TYPE_DEFAULT_VISIBILITY perf_counters
+{
+  int fds[perf_event::size];
+
+#ifdef __linux__
+  static INLINE int open_event(std::uint32_t type, std::uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  static constexpr std::uint64_t cache_event(std::uint64_t cache, std::uint64_t op, std::uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+  }
+#endif
+
+public:
+  // Nothing is counted unless enabled, so callers need not branch on whether they want counts.
+  INLINE explicit perf_counters(bool enabled = true) {
+    for (int& fd : fds) fd = -1;
+    if (!enabled) return;
+#ifdef __linux__
+    fds[perf_event::cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds[perf_event::instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds[perf_event::branch_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    fds[perf_event::l1d_read_misses] = open_event(PERF_TYPE_HW_CACHE,
+      cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    fds[perf_event::llc_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds[perf_event::dtlb_read_misses] = open_event(PERF_TYPE_HW_CACHE,
+      cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+#endif
+  }
+
+  perf_counters(perf_counters const&) = delete;
+  perf_counters& operator=(perf_counters const&) = delete;
+
+  INLINE ~perf_counters() {
+#ifdef __linux__
+    for (int fd : fds) if (-1 != fd) ::close(fd);
+#endif
+  }
+
+  // Whether any event can be counted.
+  INLINE bool is_open() const {
+    for (int fd : fds) if (-1 != fd) return true;
+    return false;
+  }
+
+  INLINE void start() {
+#ifdef __linux__
+    for (int fd : fds) if (-1 != fd) ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    for (int fd : fds) if (-1 != fd) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+  }
+
+  INLINE perf_counts stop() {
+    perf_counts result = make_unavailable_perf_counts();
+#ifdef __linux__
+    for (int fd : fds) if (-1 != fd) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    for (int i = 0; i != perf_event::size; ++i) {
+      // value, time enabled, time running
+      std::uint64_t buffer[3];
+      if (-1 == fds[i] || ssize_t(sizeof(buffer)) != ::read(fds[i], buffer, sizeof(buffer)) || 0 == buffer[2]) continue;
+      result.values[i] = double(buffer[0]) * (double(buffer[1]) / double(buffer[2]));
+    }
+#endif
+    return result;
+  }
+};
+
+} // namespace range2
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef INCLUDED_PIPELINE
+#define INCLUDED_PIPELINE
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHMS
+#include "algorithms.h"
+#endif
+
+#ifndef INCLUDED_UTILITY
+#define INCLUDED_UTILITY
+#include <utility>
+#endif
+
+namespace range2 {
+
+// Pipeline expressions
+//   range | transform(f) | filter(p) | reduce(op, z)
+// Each stage wraps the operation of the stage downstream of it, so once the terminal stage
+// is reached the whole expression is a single function object applied by one for_each loop.
+// Unlike the rest of the library the stages are passed values rather than iterators, as
+// after a transform there is no iterator to pass.
+
+template<typename F, typename Next>
+struct TYPE_HIDDEN_VISIBILITY transform_op
+{
+  F f;
+  Next next;
+
+  template<typename T>
+  ALWAYS_INLINE_HIDDEN void operator()(T&& x) {
+    next(f(std::forward<T>(x)));
+  }
+
+  ALWAYS_INLINE_HIDDEN auto result() -> decltype( next.result() ) {
+    return next.result();
+  }
+};
+
+template<typename Pred, typename Next>
+struct TYPE_HIDDEN_VISIBILITY filter_op
+{
+  Pred p;
+  Next next;
+
+  template<typename T>
+  ALWAYS_INLINE_HIDDEN void operator()(T&& x) {
+    if (p(x)) next(std::forward<T>(x));
+  }
+
+  ALWAYS_INLINE_HIDDEN auto result() -> decltype( next.result() ) {
+    return next.result();
+  }
+};
+
+// Holds the state by value, as for_each returns the op; through a pointer the state is
+// loaded and stored for every element whenever for_each is not inlined into the caller.
+template<typename Op, typename State>
+struct TYPE_HIDDEN_VISIBILITY reduce_sink
+{
+  Op op;
+  State state;
+
+  template<typename T>
+  ALWAYS_INLINE_HIDDEN void operator()(T&& x) {
+    state = op(state, std::forward<T>(x));
+  }
+
+  ALWAYS_INLINE_HIDDEN State& result() {
+    return state;
+  }
+};
+
+
+template<typename T>
+struct TYPE_HIDDEN_VISIBILITY IsPipelineStage : std::false_type {};
+
+struct TYPE_HIDDEN_VISIBILITY identity_stage
+{
+  template<typename Next>
+  ALWAYS_INLINE_HIDDEN Next wrap(Next next) const {
+    return next;
+  }
+};
+
+template<typename F>
+struct TYPE_HIDDEN_VISIBILITY transform_stage
+{
+  F f;
+
+  template<typename Next>
+  ALWAYS_INLINE_HIDDEN transform_op<F, Next> wrap(Next next) const {
+    return {f, cmove(next)};
+  }
+};
+
+template<typename F>
+struct TYPE_HIDDEN_VISIBILITY IsPipelineStage<transform_stage<F>> : std::true_type {};
+
+template<typename F>
+ALWAYS_INLINE_HIDDEN transform_stage<F> transform(F f) {
+  return {cmove(f)};
+}
+
+template<typename Pred>
+struct TYPE_HIDDEN_VISIBILITY filter_stage
+{
+  Pred p;
+
+  template<typename Next>
+  ALWAYS_INLINE_HIDDEN filter_op<Pred, Next> wrap(Next next) const {
+    return {p, cmove(next)};
+  }
+};
+
+template<typename Pred>
+struct TYPE_HIDDEN_VISIBILITY IsPipelineStage<filter_stage<Pred>> : std::true_type {};
+
+template<typename Pred>
+ALWAYS_INLINE_HIDDEN filter_stage<Pred> filter(Pred p) {
+  return {cmove(p)};
+}
+
+// Upstream stage wraps the downstream one.
+template<typename Upstream, typename Downstream>
+struct TYPE_HIDDEN_VISIBILITY composed_stage
+{
+  Upstream upstream;
+  Downstream downstream;
+
+  template<typename Next>
+  ALWAYS_INLINE_HIDDEN auto wrap(Next next) const -> decltype( std::declval<Upstream const&>().wrap(std::declval<Downstream const&>().wrap(next)) ) {
+    return upstream.wrap(downstream.wrap(cmove(next)));
+  }
+};
+
+template<typename Op, typename State>
+struct TYPE_HIDDEN_VISIBILITY reduce_stage
+{
+  Op op;
+  State z;
+};
+
+template<typename Op, typename State>
+ALWAYS_INLINE_HIDDEN reduce_stage<Op, State> reduce(Op op, State z) {
+  return {cmove(op), cmove(z)};
+}
+
+
+template<typename Rng, typename Stages>
+struct TYPE_HIDDEN_VISIBILITY pipeline
+{
+  Rng range;
+  Stages stages;
+};
+
+template<typename Iterator, typename End, typename Count, typename Stage>
+ALWAYS_INLINE_HIDDEN typename std::enable_if<IsPipelineStage<Stage>::value, pipeline<Range<Iterator, End, Count>, Stage>>::type
+operator|(Range<Iterator, End, Count> const& r, Stage s) {
+  return {r, cmove(s)};
+}
+
+template<typename Rng, typename Stages, typename Stage>
+ALWAYS_INLINE_HIDDEN typename std::enable_if<IsPipelineStage<Stage>::value, pipeline<Rng, composed_stage<Stages, Stage>>>::type
+operator|(pipeline<Rng, Stages> const& p, Stage s) {
+  return {p.range, {p.stages, cmove(s)}};
+}
+
+template<typename Rng, typename Stages, typename Op, typename State>
+ALWAYS_INLINE_HIDDEN State
+operator|(pipeline<Rng, Stages> const& p, reduce_stage<Op, State> t) {
+  static_assert(IsAFiniteRange<Rng>::value, "Must be a finite range");
+  auto tmp = for_each(p.range, make_derefop(p.stages.wrap(reduce_sink<Op, State>{cmove(t.op), cmove(t.z)})));
+  return cmove(tmp.m0.op.result());
+}
+
+template<typename Iterator, typename End, typename Count, typename Op, typename State>
+ALWAYS_INLINE_HIDDEN State
+operator|(Range<Iterator, End, Count> const& r, reduce_stage<Op, State> t) {
+  return pipeline<Range<Iterator, End, Count>, identity_stage>{r, {}} | cmove(t);
+}
+
+struct TYPE_HIDDEN_VISIBILITY Reduce_Pipeline { typedef Reduce_Pipeline type; };
+
+// However many stages, reducing a pipeline is one for_each over its range.
+template<typename Rng, typename Stages>
+struct TYPE_HIDDEN_VISIBILITY Complexity<Reduce_Pipeline, pipeline<Rng, Stages>> : CostPlan<ConstantComplexity, LinearComplexity> {};
+
+} // namespace range2
+
+#endif
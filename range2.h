@@ -46,6 +46,46 @@ struct TYPE_HIDDEN_VISIBILITY if_<false, T, F> {
 };
 
 
+// Cheapest first.
+template<typename C>
+struct TYPE_HIDDEN_VISIBILITY ComplexityRank;
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY ComplexityRank<ConstantComplexity> : std::integral_constant<int, 0> {};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY ComplexityRank<LogarithmicComplexity> : std::integral_constant<int, 1> {};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY ComplexityRank<LinearComplexity> : std::integral_constant<int, 2> {};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY ComplexityRank<LogarithmicLinearComplexity> : std::integral_constant<int, 3> {};
+
+template<>
+struct TYPE_HIDDEN_VISIBILITY ComplexityRank<UndefinedComplexity> : std::integral_constant<int, 4> {};
+
+// Complexity of steps taken one after another, which is that of the most expensive step.
+template<typename... C>
+struct TYPE_HIDDEN_VISIBILITY SequentialComplexity;
+
+template<typename C>
+struct TYPE_HIDDEN_VISIBILITY SequentialComplexity<C> : C::type {};
+
+template<typename C0, typename C1, typename... C>
+struct TYPE_HIDDEN_VISIBILITY SequentialComplexity<C0, C1, C...> :
+  SequentialComplexity<typename if_<(ComplexityRank<typename C0::type>::value >= ComplexityRank<typename C1::type>::value), typename C0::type, typename C1::type>::type, C...> {};
+
+// The complexity of an operation split into the setup it performs on its ranges, such as finding
+// an end or count it needs, and the traversal that follows. Generic code can ask whether a call
+// costs an extra pass before making it.
+template<typename Setup, typename Traversal>
+struct TYPE_HIDDEN_VISIBILITY CostPlan : SequentialComplexity<Setup, Traversal> {
+  typedef typename Setup::type setup;
+  typedef typename Traversal::type traversal;
+};
+
+
 template<typename Op, typename... Params>
 struct TYPE_HIDDEN_VISIBILITY Complexity;
 
@@ -439,7 +479,7 @@ struct CanAddEndInLinearTime<Range<Iterator, NotPresent, Count>> :
 struct TYPE_HIDDEN_VISIBILITY AddEnd { typedef AddEnd type; };
 
 template<typename Iterator, typename Count>
-struct TYPE_HIDDEN_VISIBILITY Complexity<AddEnd, Range<Iterator, Present, Count>> : ConstantComplexity {};
+struct TYPE_HIDDEN_VISIBILITY Complexity<AddEnd, Range<Iterator, Present, Count>, void> : ConstantComplexity {};
 
 template<typename Iterator, typename Count>
 struct TYPE_HIDDEN_VISIBILITY Complexity<AddEnd, Range<Iterator, NotPresent, Count>, typename std::enable_if<ConstantTimeEnd<Range<Iterator, NotPresent, Count>>::value, void>::type> : ConstantComplexity {};
@@ -524,13 +564,13 @@ struct CanAddCountInLinearTime<Range<Iterator, End, NotPresent>> :
 struct TYPE_HIDDEN_VISIBILITY AddCount { typedef AddCount type; };
 
 template<typename Iterator, typename End>
-struct TYPE_HIDDEN_VISIBILITY Complexity<AddCount, Range<Iterator, End, Present>> : ConstantComplexity {};
+struct TYPE_HIDDEN_VISIBILITY Complexity<AddCount, Range<Iterator, End, Present>, void> : ConstantComplexity {};
 
 template<typename Iterator, typename End>
-struct TYPE_HIDDEN_VISIBILITY Complexity<AddCount, Range<Iterator, End, Present>, typename std::enable_if<ConstantTimeCount<Range<Iterator, End, Present>>::value, void>::type> : ConstantComplexity {};
+struct TYPE_HIDDEN_VISIBILITY Complexity<AddCount, Range<Iterator, End, NotPresent>, typename std::enable_if<ConstantTimeCount<Range<Iterator, End, NotPresent>>::value, void>::type> : ConstantComplexity {};
 
 template<typename Iterator, typename End>
-struct TYPE_HIDDEN_VISIBILITY Complexity<AddCount, Range<Iterator, End, Present>, typename std::enable_if<!ConstantTimeCount<Range<Iterator, End, Present>>::value, void>::type> : if_<CanAddCountInLinearTime<Range<Iterator, End, Present>>::value, LinearComplexity, UndefinedComplexity> {};
+struct TYPE_HIDDEN_VISIBILITY Complexity<AddCount, Range<Iterator, End, NotPresent>, typename std::enable_if<!ConstantTimeCount<Range<Iterator, End, NotPresent>>::value, void>::type> : if_<CanAddCountInLinearTime<Range<Iterator, End, NotPresent>>::value, LinearComplexity, UndefinedComplexity> {};
 
 
 // Already present
@@ -590,27 +630,27 @@ struct TYPE_HIDDEN_VISIBILITY split_impl<Range<Iterator, End, Count>, NotPresent
 
 template<typename Iterator, typename End, typename Middle>
 struct TYPE_HIDDEN_VISIBILITY split_impl<Range<Iterator, End, NotPresent>, Middle, NotPresent, typename std::enable_if<!std::is_same<NotPresent, Middle>::value, void>::type> {
-  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, End, NotPresent> const& x, Middle middle, NotPresent) -> decltype( make_pair(make_range(get_begin(x), middle, NotPresent{}), make_range(middle, get_end(x), NotPresent{})) ) {
-    return make_pair(make_range(get_begin(x), middle, NotPresent{}), make_range(middle, get_end(x), NotPresent{}));
+  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, End, NotPresent> const& x, Middle middle, NotPresent) -> decltype( range2::make_pair(make_range(get_begin(x), middle, NotPresent{}), make_range(middle, get_end(x), NotPresent{})) ) {
+    return range2::make_pair(make_range(get_begin(x), middle, NotPresent{}), make_range(middle, get_end(x), NotPresent{}));
   }
 };
 
 template<typename Iterator, typename Middle>
 struct TYPE_HIDDEN_VISIBILITY split_impl<Range<Iterator, NotPresent, Present>, Middle, NotPresent, typename std::enable_if<!std::is_same<NotPresent, Middle>::value, void>::type> {
-  static ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, NotPresent, Present> const& x, Middle middle, NotPresent) -> decltype( make_pair(make_range(get_begin(x), middle, DifferenceType<Iterator>()), make_range(middle, NotPresent{}, DifferenceType<Iterator>()))) {
+  static ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, NotPresent, Present> const& x, Middle middle, NotPresent) -> decltype( range2::make_pair(make_range(get_begin(x), middle, DifferenceType<Iterator>()), make_range(middle, NotPresent{}, DifferenceType<Iterator>()))) {
     // std::distance not constexpr in C++11
     DifferenceType<Iterator> diff = std::distance(get_begin(x), middle);
     DifferenceType<Iterator> c = get_count(x) - diff;
-    return make_pair(make_range(get_begin(x), middle, diff), make_range(middle, NotPresent{}, c));
+    return range2::make_pair(make_range(get_begin(x), middle, diff), make_range(middle, NotPresent{}, c));
   }
 };
 
 
 template<typename Iterator, typename Middle>
 struct TYPE_HIDDEN_VISIBILITY split_impl<Range<Iterator, Present, Present>, Middle, NotPresent, typename std::enable_if<!std::is_same<NotPresent, Middle>::value, void>::type> {
-  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, Present, Present> const& x, Middle middle, NotPresent) -> decltype( make_pair(make_range(get_begin(x), middle, NotPresent{}), make_range(middle, get_end(x), NotPresent{})) ) {
+  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, Present, Present> const& x, Middle middle, NotPresent) -> decltype( range2::make_pair(make_range(get_begin(x), middle, NotPresent{}), make_range(middle, get_end(x), NotPresent{})) ) {
      // No need to calculate the diff as the end iterator is present
-    return make_pair(make_range(get_begin(x), middle, NotPresent{}), make_range(middle, get_end(x), NotPresent{}));
+    return range2::make_pair(make_range(get_begin(x), middle, NotPresent{}), make_range(middle, get_end(x), NotPresent{}));
   }
 };
 
@@ -618,26 +658,26 @@ struct TYPE_HIDDEN_VISIBILITY split_impl<Range<Iterator, Present, Present>, Midd
 
 template<typename Iterator, typename End, typename Middle, typename LHSCount>
 struct TYPE_HIDDEN_VISIBILITY split_impl<Range<Iterator, End, Present>, Middle, LHSCount, typename std::enable_if<!std::is_same<NotPresent, Middle>::value && !std::is_same<NotPresent, LHSCount>::value, void>::type> {
-  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, End, Present> const& x, Middle middle, LHSCount lhsCount) -> decltype( make_pair(make_range(get_begin(x), middle, lhsCount), make_range(middle, get_end(x), get_count(x) - lhsCount)) ) {
-    return make_pair(make_range(get_begin(x), middle, lhsCount), make_range(middle, get_end(x), get_count(x) - lhsCount));
+  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, End, Present> const& x, Middle middle, LHSCount lhsCount) -> decltype( range2::make_pair(make_range(get_begin(x), middle, lhsCount), make_range(middle, get_end(x), get_count(x) - lhsCount)) ) {
+    return range2::make_pair(make_range(get_begin(x), middle, lhsCount), make_range(middle, get_end(x), get_count(x) - lhsCount));
   }
 };
 
 
 template<typename Iterator, typename End, typename Middle, typename LHSCount>
 struct TYPE_HIDDEN_VISIBILITY split_impl<Range<Iterator, End, NotPresent>, Middle, LHSCount, typename std::enable_if<!std::is_same<NotPresent, Middle>::value && !std::is_same<NotPresent, LHSCount>::value, void>::type> {
-  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, End, NotPresent> const& x, Middle middle, LHSCount lhsCount) -> decltype( make_pair(make_range(get_begin(x), middle, lhsCount), make_range(middle, get_end(x), NotPresent{})) ) {
-    return make_pair(make_range(get_begin(x), middle, lhsCount), make_range(middle, get_end(x), NotPresent{}));
+  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, End, NotPresent> const& x, Middle middle, LHSCount lhsCount) -> decltype( range2::make_pair(make_range(get_begin(x), middle, lhsCount), make_range(middle, get_end(x), NotPresent{})) ) {
+    return range2::make_pair(make_range(get_begin(x), middle, lhsCount), make_range(middle, get_end(x), NotPresent{}));
   }
 };
 
 
 template<typename Iterator, typename End, typename Count, typename LHSCount>
 struct TYPE_HIDDEN_VISIBILITY split_impl<Range<Iterator, End, Count>, NotPresent, LHSCount, typename std::enable_if<!std::is_same<NotPresent, LHSCount>::value, void>::type> {
-  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, End, Count> const& x, NotPresent, LHSCount lhsCount) -> decltype( split_impl<Range<Iterator, End, Count>, Iterator, LHSCount>::apply(x, advance(get_begin(x), lhsCount), lhsCount) ) {
+  static constexpr ALWAYS_INLINE_HIDDEN auto apply(Range<Iterator, End, Count> const& x, NotPresent, LHSCount lhsCount) -> decltype( split_impl<Range<Iterator, End, Count>, Iterator, LHSCount>::apply(x, range2::advance(get_begin(x), lhsCount), lhsCount) ) {
     // We must calculate the middle in order for the second range to be able to start somewhere.
     // Not really recursion as the split_impl type is different (Middle is now present).
-    return split_impl<Range<Iterator, End, Count>, Iterator, LHSCount>::apply(x, advance(get_begin(x), lhsCount), lhsCount);
+    return split_impl<Range<Iterator, End, Count>, Iterator, LHSCount>::apply(x, range2::advance(get_begin(x), lhsCount), lhsCount);
   } 
 };
 
@@ -679,7 +719,7 @@ split_at(Range<Iterator, End, Count> const& x, Middle middle, LHSCount lhsCount)
 struct TYPE_HIDDEN_VISIBILITY Split_At { typedef Split_At type; };
 
 template<typename Iterator, typename End, typename Count, typename Middle, typename LHSCount>
-struct TYPE_HIDDEN_VISIBILITY Complexity<Split_At, Range<Iterator, End, Count>, Middle, LHSCount> : Complexity<split_impl, Range<Iterator, End, Count>, Middle, LHSCount> {};
+struct TYPE_HIDDEN_VISIBILITY Complexity<Split_At, Range<Iterator, End, Count>, Middle, LHSCount> : Complexity<split_impl, Range<Iterator, End, Count>, Middle, LHSCount, void> {};
 
 namespace impl {
 
@@ -709,7 +749,7 @@ join(Range<Iterator0, End0, Count0> const& x, Range<Iterator1, End1, Count1> con
 struct TYPE_HIDDEN_VISIBILITY Join { typedef Join type; };
 
 template<typename Iterator0, typename End0, typename Count0, typename Iterator1, typename End1, typename Count1>
-struct TYPE_HIDDEN_VISIBILITY Complexity<Join, Range<Iterator0, End0, Count0>, Range<Iterator1, End1, Count1>> : ConstantComplexity {};
+struct TYPE_HIDDEN_VISIBILITY Complexity<Join, Range<Iterator0, End0, Count0>, Range<Iterator1, End1, Count1>> : CostPlan<ConstantComplexity, ConstantComplexity> {};
 
 
 template<typename Iterator0, typename End0, typename Count0, typename Iterator1>
@@ -722,7 +762,7 @@ join(Range<Iterator0, End0, Count0> const& x, Range<Iterator1, NotPresent, Prese
 }
 
 template<typename Iterator0, typename End0, typename Count0, typename Iterator1>
-struct TYPE_HIDDEN_VISIBILITY Complexity<Join, Range<Iterator0, End0, Count0>, Range<Iterator1, NotPresent, Present>> : Complexity<AddEnd, Range<Iterator1, NotPresent, Present>> {};
+struct TYPE_HIDDEN_VISIBILITY Complexity<Join, Range<Iterator0, End0, Count0>, Range<Iterator1, NotPresent, Present>> : CostPlan<Complexity<AddEnd, Range<Iterator1, NotPresent, Present>, void>, ConstantComplexity> {};
 
 
 struct TYPE_HIDDEN_VISIBILITY Reverse_Impl { typedef Reverse_Impl type; };
@@ -749,10 +789,10 @@ struct TYPE_HIDDEN_VISIBILITY reverse_impl<Range<Iterator, NotPresent, Present>>
 } // namespace impl
 
 template<typename Iterator, typename Count>
-struct TYPE_HIDDEN_VISIBILITY Complexity<Reverse_Impl, Range<Iterator, Present, Count>> : ConstantComplexity {};
+struct TYPE_HIDDEN_VISIBILITY Complexity<Reverse_Impl, Range<Iterator, Present, Count>> : CostPlan<ConstantComplexity, ConstantComplexity> {};
 
 template<typename Iterator>
-struct TYPE_HIDDEN_VISIBILITY Complexity<Reverse_Impl, Range<Iterator, NotPresent, Present>> : Complexity<AddEnd, Range<Iterator, NotPresent, Present>> {};
+struct TYPE_HIDDEN_VISIBILITY Complexity<Reverse_Impl, Range<Iterator, NotPresent, Present>> : CostPlan<Complexity<AddEnd, Range<Iterator, NotPresent, Present>, void>, ConstantComplexity> {};
 
 
 template<typename Iterator, typename End, typename Count>
@@ -792,10 +832,34 @@ skip(Range<Iterator, End, Count> const& x) -> decltype ( make_range(make_skip_it
   return make_range(make_skip_iterator<N>(get_begin(x)), impl::make_skip_iterator_impl<N>(get_end(x)), get_count(x)/N);
 }
 
+namespace impl {
+
+template<typename Stride>
+ALWAYS_INLINE_HIDDEN NotPresent make_skip_iterator_impl(NotPresent x, Stride) {
+  return x;
+}
+
+template<typename Iterator>
+ALWAYS_INLINE_HIDDEN auto make_skip_iterator_impl(Iterator x, DifferenceType<Iterator> n) -> decltype( make_skip_iterator(x, n) ) {
+  return make_skip_iterator(x, n);
+}
+
+} // namespace impl
+
+// Runtime stride equivalent of skip<N>
+template<typename Iterator, typename End, typename Count>
+constexpr ALWAYS_INLINE_HIDDEN auto
+skip(Range<Iterator, End, Count> const& x, DifferenceType<Iterator> n) -> decltype ( make_range(make_skip_iterator(get_begin(x), n), impl::make_skip_iterator_impl(get_end(x), n), get_count(x)/n) ) {
+
+  static_assert(std::is_same<Count, Present>::value, "Count must be present to form a valid skip iterator");
+  // Precondition n > 0 && get_count(x) % n == 0
+  return make_range(make_skip_iterator(get_begin(x), n), impl::make_skip_iterator_impl(get_end(x), n), get_count(x)/n);
+}
+
 template<typename Iterator, typename End>
-constexpr ALWAYS_INLINE_HIDDEN pair<Range<Iterator, Present, Present>, Range<Iterator, Present, Present>>
-splitInTwo (Range<Iterator, End, Present> const& x) {
-  return split_at(x, NotPresent{}, getCount(x)/2);
+constexpr ALWAYS_INLINE_HIDDEN auto
+splitInTwo (Range<Iterator, End, Present> const& x) -> decltype( split_at(x, NotPresent{}, get_count(x)/2) ) {
+  return split_at(x, NotPresent{}, get_count(x)/2);
 }
 
 } // namespace range2
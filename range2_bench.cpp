@@ -0,0 +1,336 @@
+#include "range2.h"
+#include "algorithms.h"
+#include "pipeline.h"
+#include "record_stream.h"
+#include "bit_range.h"
+#include "byte_search.h"
+#include "benchmark.h"
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <functional>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+
+namespace range2 {
+namespace {
+
+  typedef unsigned long long SumType;
+
+  template<typename T>
+  SumType sumOver(T x) {
+    SumType tmp = 0;
+    for_each(x, make_derefop([&tmp](SumType x) { tmp += x; }));
+    return tmp;
+  }
+
+  constexpr std::size_t performanceElements = 1000000;
+
+  template<typename T, typename Op>
+  void performanceTestImpl(T x, char const* const description, char const* unrollDescription, Op op) {
+    SumType sum = 0U;
+    auto result = run_benchmark([&]() -> SumType { return sum += op(x); }, performanceElements, performanceElements * sizeof(SumType));
+    std::cout << sum << ' ' << unrollDescription;
+    report(std::cout, result, description);
+  }
+
+  template<typename T>
+  SumType sumOverPlain(T x) {
+    SumType tmp = 0;
+    impl::for_each_loop(add_constant_time_count(x), make_derefop([&tmp](SumType x) { tmp += x; }));
+    return tmp;
+  }
+
+  template<int N, typename T>
+  SumType sumOverUnrolled(T x) {
+    SumType tmp = 0;
+    impl::for_each_unrolled<N>(add_constant_time_count(x), make_derefop([&tmp](SumType x) { tmp += x; }));
+    return tmp;
+  }
+
+  struct Identity {
+    template<typename I>
+    SumType operator()(I x) const { return *x; }
+  };
+
+  template<typename T>
+  SumType reduceOverPlain(T x) {
+    return impl::reduce_nonempty_loop(add_constant_time_count(x), std::plus<SumType>{}, Identity{}).m0;
+  }
+
+  template<typename T>
+  SumType reduceOverUnrolled(T x) {
+    return impl::reduce_nonempty_unrolled(add_constant_time_count(x), std::plus<SumType>{}, Identity{}).m0;
+  }
+
+  struct Odd {
+    template<typename I>
+    bool operator()(I x) const { return 0 != (*x & 1); }
+  };
+
+  template<typename T>
+  SumType countIfOverPlain(T x) {
+    return impl::count_if_loop(add_constant_time_count(x), Odd{}, SumType(0));
+  }
+
+  template<typename T>
+  SumType countIfOverUnrolled(T x) {
+    return impl::count_if_unrolled(add_constant_time_count(x), Odd{}, SumType(0));
+  }
+
+  // Never matches, the values starting at 5, so the whole range is searched
+  struct IsZero {
+    template<typename I>
+    bool operator()(I x) const { return 0 == *x; }
+  };
+
+  template<typename T>
+  SumType findIfOverPlain(T x) {
+    auto tmp = add_constant_time_count(x);
+    return get_count(tmp) - get_count(impl::find_if_loop(tmp, IsZero{}));
+  }
+
+  template<typename T>
+  SumType findIfOverUnrolled(T x) {
+    auto tmp = add_constant_time_count(x);
+    return get_count(tmp) - get_count(impl::find_if_unrolled(tmp, IsZero{}));
+  }
+
+  // Every Range shape is counted in constant time by add_constant_time_count, so all can be unrolled.
+  template<typename T>
+  void performanceTest(T x, char const* const description) {
+    performanceTestImpl(x, description, "for_each plain ", [](T x) -> SumType { return sumOverPlain(x); });
+    performanceTestImpl(x, description, "for_each unrolled 4 ", [](T x) -> SumType { return sumOverUnrolled<4>(x); });
+    performanceTestImpl(x, description, "reduce plain ", [](T x) -> SumType { return reduceOverPlain(x); });
+    performanceTestImpl(x, description, "reduce unrolled ", [](T x) -> SumType { return reduceOverUnrolled(x); });
+    performanceTestImpl(x, description, "count_if plain ", [](T x) -> SumType { return countIfOverPlain(x); });
+    performanceTestImpl(x, description, "count_if unrolled ", [](T x) -> SumType { return countIfOverUnrolled(x); });
+    performanceTestImpl(x, description, "find_if plain ", [](T x) -> SumType { return findIfOverPlain(x); });
+    performanceTestImpl(x, description, "find_if unrolled ", [](T x) -> SumType { return findIfOverUnrolled(x); });
+  }
+
+  template<int LinearSearchLength, typename T>
+  void performanceTestPartitionPoint(T x, char const* const description, std::vector<SumType> const& toFind) {
+    SumType sum = 0;
+    SumType s = 0;
+    auto op = [&s](SumType y) { return s < y; };
+    auto pred = make_derefop(op);
+    auto toFindSize = toFind.size();
+    auto result = run_benchmark([&]() -> SumType {
+      for (std::size_t i=0; i < toFindSize; ++i) {
+        s = toFind[i];
+        //auto tmp = partition_point(x, pred, p);
+        auto tmp = bisecting_search<T, LinearSearchLength>(x, pred, impl::Halve{});
+        if (!is_empty(tmp.m1)) sum += *get_begin(tmp.m1);
+      }
+      return sum;
+    }, toFindSize, 0);
+    std::cout << "bisecting_search sum" << sum << ' ';
+    report(std::cout, result, description);
+  }
+
+  // Per query latency distribution, which batch totals hide.
+  template<int LinearSearchLength, typename T>
+  void latencyTestPartitionPoint(T x, char const* const description, std::vector<SumType> const& toFind) {
+    SumType s = 0;
+    auto pred = make_derefop([&s](SumType y) { return s < y; });
+    latency_histogram h;
+    cycle_timer t;
+    for (std::size_t i = 0; i != toFind.size() && i != 100000; ++i) {
+      s = toFind[i];
+      t.start();
+      auto tmp = bisecting_search<T, LinearSearchLength>(x, pred, impl::Halve{});
+      do_not_optimize(tmp);
+      h.record(static_cast<std::uint64_t>(t.stop() + 0.5));
+    }
+    std::cout << "bisecting_search latency ";
+    report(std::cout, h, description);
+  }
+
+  void testPerformance() {
+    typedef std::vector<SumType> V;
+    V v(performanceElements);
+    std::iota(v.begin(), v.end(), 5);
+
+    auto r0 = make_range(v.begin(), v.end(), NotPresent{});
+    auto r1 = make_range(v.begin(), NotPresent{}, v.size());
+    auto r2 = make_range(v.begin(), v.end(), v.size());
+
+    auto r3 = make_range(make_iterator(v.begin()), make_iterator(v.end()), NotPresent{});
+    auto r4 = make_range(make_iterator(v.begin()), NotPresent{}, v.size());
+    auto r5 = make_range(make_iterator(v.begin()), make_iterator(v.end()), v.size());
+
+    performanceTest(r0, " Bounded Range");
+    performanceTest(reverse(r0), " Reverse Bounded Range");
+    performanceTest(r3, " Bounded wrapped Range");
+    performanceTest(reverse(r3), " Reverse Bounded wrapped Range");
+
+    performanceTest(r1, " Counted Range");
+    performanceTest(reverse(r1), " Reversed Counted Range");
+    performanceTest(r2, " Bounded and Counted Range");
+    performanceTest(reverse(r2), " Reversed Bounded and Counted Range");
+    performanceTest(r4, " Counted wrapped Range");
+    performanceTest(reverse(r4), " Reversed Counted wrapped Range");
+    performanceTest(r5, " Bounded and Counted wrapped Range");
+    performanceTest(reverse(r5), " Reverse Bounded and Counted wrapped Range");
+
+    performanceTestImpl(std::cref(v), "std::accumulate", "", [](std::reference_wrapper<V const> x) -> SumType { return std::accumulate(x.get().cbegin(), x.get().cend(), SumType(0)); });
+
+    // Single loop pipeline against the equivalent hand written loop
+    auto triple = [](SumType x) -> SumType { return 3 * x; };
+    auto odd = [](SumType x) -> bool { return 0 != (x & 1); };
+    auto plus = [](SumType x, SumType y) -> SumType { return x + y; };
+    // Over the same iterator and count as the pipeline, in the shape for_each_unrolled<4> gives it
+    performanceTestImpl(r2, " Hand written transform/filter/reduce Bounded and Counted Range", "", [](decltype(r2) x) -> SumType {
+      SumType sum = 0;
+      auto i = get_begin(x);
+      auto n = get_count(x);
+      for (; n >= 4; n -= 4, i += 4) {
+        auto y0 = 3 * i[0];
+        if (0 != (y0 & 1)) sum += y0;
+        auto y1 = 3 * i[1];
+        if (0 != (y1 & 1)) sum += y1;
+        auto y2 = 3 * i[2];
+        if (0 != (y2 & 1)) sum += y2;
+        auto y3 = 3 * i[3];
+        if (0 != (y3 & 1)) sum += y3;
+      }
+      for (; n != 0; --n, ++i) {
+        auto y = 3 * *i;
+        if (0 != (y & 1)) sum += y;
+      }
+      return sum;
+    });
+    performanceTestImpl(r2, " Pipeline transform/filter/reduce Bounded and Counted Range", "", [&](decltype(r2) x) -> SumType { return x | transform(triple) | filter(odd) | reduce(plus, SumType(0)); });
+    performanceTestImpl(r5, " Pipeline transform/filter/reduce Bounded and Counted wrapped Range", "", [&](decltype(r5) x) -> SumType { return x | transform(triple) | filter(odd) | reduce(plus, SumType(0)); });
+
+    V v2 = v;
+    std::random_shuffle(v2.begin(), v2.end());
+
+    performanceTestPartitionPoint<0>(r1, " Counted Range 0", v2);
+    performanceTestPartitionPoint<8>(r1, " Counted Range 8", v2);
+    performanceTestPartitionPoint<16>(r1, " Counted Range 16", v2);
+    performanceTestPartitionPoint<32>(r1, " Counted Range 32", v2);
+    performanceTestPartitionPoint<64>(r1, " Counted Range 64", v2);
+
+    latencyTestPartitionPoint<0>(r1, " Counted Range 0", v2);
+    latencyTestPartitionPoint<16>(r1, " Counted Range 16", v2);
+  }
+
+  template<typename Op>
+  void throughputTest(std::size_t elements, std::size_t bytes, char const* description, Op op) {
+    report(std::cout, run_benchmark(op, elements, bytes), description);
+  }
+
+  void testRecordStreamPerformance() {
+    constexpr std::size_t n = std::size_t(1) << 23;
+    char path[] = "/tmp/range2_perfXXXXXX";
+    int fd = mkstemp(path);
+    assert(-1 != fd);
+    {
+      std::vector<SumType> v(n);
+      std::iota(v.begin(), v.end(), 5);
+      auto written = ::write(fd, v.data(), n * sizeof(SumType));
+      assert(written == static_cast<ssize_t>(n * sizeof(SumType)));
+      (void)written;
+    }
+    constexpr std::size_t bytes = n * sizeof(SumType);
+
+    throughputTest(n, bytes, " Read whole file then sum", [fd]() -> SumType {
+      ::lseek(fd, 0, SEEK_SET);
+      std::vector<SumType> v(n);
+      impl::fill_buffer(fd, reinterpret_cast<char*>(v.data()), bytes);
+      return sumOver(make_range(v.data(), NotPresent{}, n));
+    });
+    throughputTest(n, bytes, " Stream and sum", [fd]() -> SumType {
+      ::lseek(fd, 0, SEEK_SET);
+      record_stream<SumType> stream(fd);
+      return sumOver(make_stream_range(stream));
+    });
+    throughputTest(n, bytes, " Stream with read ahead and sum", [fd]() -> SumType {
+      ::lseek(fd, 0, SEEK_SET);
+      record_stream<SumType> stream(fd, std::size_t(1) << 16, true);
+      return sumOver(make_stream_range(stream));
+    });
+    ::close(fd);
+    std::remove(path);
+  }
+
+  void testBitRangePerformance() {
+    constexpr std::ptrdiff_t n = std::ptrdiff_t(1) << 26;
+    constexpr std::size_t bytes = n / 8;
+    std::vector<bool> flags(n);
+    bit_vector bits(n);
+    auto r = bits.range();
+    for (std::ptrdiff_t i = 0; i < n; i += 5) {
+      flags[i] = true;
+      sink(get_begin(r) + i, true);
+    }
+
+    throughputTest(n, bytes, " std::count over std::vector<bool>", [&flags]() -> SumType {
+      return std::count(flags.begin(), flags.end(), true);
+    });
+    throughputTest(n, bytes, " count_if bit by bit", [r]() -> SumType {
+      return count_if(r, make_derefop([](bool x) { return x; }), SumType(0));
+    });
+    throughputTest(n, bytes, " count_if word by word", [r]() -> SumType {
+      return count_if(r, bit_is_set{}, SumType(0));
+    });
+  }
+
+  template<typename Pred>
+  SumType countFields(std::vector<char> const& text, Pred p) {
+    SumType fields = 0;
+    auto r = make_range(text.data(), NotPresent{}, std::ptrdiff_t(text.size()));
+    while (!is_empty(r = find_if(r, p))) {
+      ++fields;
+      r = successor(r);
+    }
+    return fields;
+  }
+
+  void testByteSearchPerformance() {
+    constexpr std::size_t bytes = std::size_t(1) << 24;
+    std::vector<char> text(bytes);
+    for (std::size_t i = 0; i != bytes; ++i) text[i] = (i % 97 == 96) ? '\n' : (i % 31 == 30) ? ',' : char('a' + i % 26);
+
+    throughputTest(bytes, bytes, " Split lines byte by byte", [&text]() -> SumType {
+      return countFields(text, make_derefop([](char x) { return '\n' == x; }));
+    });
+    throughputTest(bytes, bytes, " Split lines with memchr", [&text]() -> SumType {
+      return countFields(text, byte_equal_to{'\n'});
+    });
+    throughputTest(bytes, bytes, " Split fields byte by byte", [&text]() -> SumType {
+      return countFields(text, make_derefop([](char x) { return '\n' == x || ',' == x; }));
+    });
+    byte_set const delimiters = make_byte_set("\n,");
+    throughputTest(bytes, bytes, " Split fields with byte_set", [&text, &delimiters]() -> SumType {
+      return countFields(text, make_byte_set_pred(&delimiters));
+    });
+
+    static char const needle[] = "abcdefghi!";
+    auto haystack = make_range(text.data(), NotPresent{}, std::ptrdiff_t(bytes));
+    throughputTest(bytes, bytes, " Substring search byte by byte", [haystack]() -> SumType {
+      auto found = search(haystack, make_range(needle, NotPresent{}, 10), make_derefop([](char x, char y) { return x == y; }));
+      return get_count(found.m1);
+    });
+    throughputTest(bytes, bytes, " Substring search first and last byte filter", [haystack]() -> SumType {
+      auto found = search(haystack, make_range(needle, NotPresent{}, 10));
+      return get_count(found.m1);
+    });
+  }
+
+} // unnamed namespace
+} // namespace range2
+
+using namespace range2;
+
+int main() {
+  testPerformance();
+  testRecordStreamPerformance();
+  testBitRangePerformance();
+  testByteSearchPerformance();
+}
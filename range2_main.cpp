@@ -1,13 +1,51 @@
 #include "range2.h"
 #include "algorithms.h"
+#include "views.h"
+#include "pipeline.h"
+#include "mapped_file.h"
+#include "record_stream.h"
+#include "append_buffer.h"
+#include "arena.h"
+#include "external_sort.h"
+#include "compressed_column.h"
+#include "bit_range.h"
+#include "byte_search.h"
+#include "perf_counters.h"
+#include "latency_histogram.h"
 #include "timer.h"
+#include "operation_counter.h"
+#include "fixed_range.h"
+#include "sized_forward_list.h"
+#include "checkpoint_index.h"
+#include "reverse_buffer.h"
+#include "task_scheduler.h"
 #include <cassert>
 #include <iostream>
 #include <vector>
 #include <numeric>
 #include <functional>
 #include <forward_list>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <new>
+
+// Counts heap allocations, so tests can check that steady state loops make none.
+// Not inlined, as GCC would then see new-expressions paired with free and warn.
+static std::atomic<std::size_t> heapAllocations(0);
+
+__attribute__((noinline)) void* operator new(std::size_t n) {
+  ++heapAllocations;
+  if (void* p = std::malloc(0 == n ? 1 : n)) return p;
+  throw std::bad_alloc();
+}
 
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+  std::free(p);
+}
 
 namespace range2 {
 namespace {
@@ -828,6 +866,63 @@ namespace {
     testSkipIteratorImpl<20>();
   }
 
+  void testRuntimeSkipIteratorImpl(int n) {
+    auto Start = make_skip_iterator(begin, n);
+    auto End = make_skip_iterator(end, n);
+    assert(begin == state(Start));
+    assert(end == state(End));
+
+    // Test successor
+    int expected = 0;
+    while (Start != End) {
+      assert(expected == *Start);
+      expected += n;
+      ++Start;
+    }
+    assert(count == expected);
+
+    // Test predecessor
+    Start = make_skip_iterator(begin, n);
+    expected = count - n;
+    while (Start != End) {
+      --End;
+      assert(expected == *End);
+      expected -= n;
+    }
+    assert(-n == expected);
+
+    End = make_skip_iterator(end, n);
+    assert(Start + count/n == End);
+    assert(End - count/n == Start);
+    assert(End - Start == count/n);
+  }
+
+  void testRuntimeSkipIterator() {
+    testRuntimeSkipIteratorImpl(1);
+    testRuntimeSkipIteratorImpl(2);
+    testRuntimeSkipIteratorImpl(4);
+    testRuntimeSkipIteratorImpl(5);
+    testRuntimeSkipIteratorImpl(10);
+    testRuntimeSkipIteratorImpl(20);
+
+    // Strides fold into a single runtime skip iterator
+    auto a = make_skip_iterator(make_skip_iterator(begin, 2), 5);
+    assert(10 == a.basis.stride);
+    auto b = make_skip_iterator<2>(make_skip_iterator(begin, 5));
+    assert(10 == b.basis.stride);
+    auto c = make_skip_iterator(make_skip_iterator<2>(begin), 5);
+    assert(10 == c.basis.stride);
+    assert(10 == *successor(a));
+    assert(10 == *successor(b));
+    assert(10 == *successor(c));
+
+    // Strides too large to share a cache line are prefetched
+    int large[64] = {};
+    large[32] = 1;
+    auto d = successor(make_skip_iterator(&large[0], 32));
+    assert(1 == *d);
+  }
+
   template<typename T>
   void testReverseImpl(T x) {
     auto range = reverse(x);
@@ -907,94 +1002,47 @@ namespace {
     testReverseSkipImpl(r11);
   }
 
-
-  typedef unsigned long long SumType;
-
   template<typename T>
-  SumType sumOver(T x) {
-    SumType tmp = 0;
-    for_each(x, make_derefop([&tmp](SumType x) { tmp += x; }));
-    return tmp;
-  }
+  void testRuntimeSkipImpl2(T x, int n) {
+    auto y = skip(x, n);
 
-  constexpr int loopTimes = 100;
-
-  template<typename T, typename Op>
-  void performanceTestImpl(T x, char const* const description, char const* unrollDescription, Op op) {
-    SumType sum = 0U;
-    timer t;
-    t.start();
-    for (int i=0; i < loopTimes; ++i) {
-      sum += op(x);
+    // Test successor
+    int expected = 0;
+    while (!is_empty(y)) {
+      assert(expected == *get_begin(y));
+      expected += n;
+      y = successor(y);
     }
-    auto time = t.stop();
-    std::cout << sum << ' ' << time << unrollDescription << description << std::endl;
+    assert(count == expected);
   }
 
   template<typename T>
-  void performanceTest(T x, char const* const description) {
-    performanceTestImpl(x, description, "", [](T x) -> SumType { return sumOver(x); });
+  void testRuntimeReverseSkipImpl2(T x, int n) {
+    int expected = count - n;
+    while (!is_empty(x)) {
+      assert(expected == *get_begin(x));
+      x = successor(x);
+      expected -= n;
+    }
+    assert(-n == expected);
+  }
+
+  void testRuntimeSkip() {
+    int const strides[] = {1, 2, 4, 5, 10, 20};
+    for (int n : strides) {
+      testRuntimeSkipImpl2(r01, n);
+      testRuntimeSkipImpl2(r11, n);
+      testRuntimeReverseSkipImpl2(reverse(skip(r01, n)), n);
+      testRuntimeReverseSkipImpl2(skip(reverse(r01), n), n);
+      testRuntimeReverseSkipImpl2(reverse(skip(r11, n)), n);
+      testRuntimeReverseSkipImpl2(skip(reverse(r11), n), n);
+    }
+    // Compile time stride folded into the runtime stride.
+    auto tmp = skip(skip<2>(r11), 5);
+    assert(4 == get_count(tmp));
+    assert(10 == *successor(get_begin(tmp)));
   }
 
-  template<int LinearSearchLength, typename T>
-  void performanceTestPartitionPoint(T x, char const* const description, std::vector<SumType> const& toFind) {
-    timer t;
-    t.start();
-    SumType sum = 0;
-    SumType s = 0;
-    auto op = [&s](SumType y) { return s < y; };
-    auto pred = make_derefop(op);
-    auto toFindSize = toFind.size();
-    for (int i=0; i < toFindSize; ++i) {
-      s = toFind[i];
-      //auto tmp = partition_point(x, pred, p);
-      auto tmp = bisecting_search<T, LinearSearchLength>(x, pred, impl::Halve{});
-      if (!is_empty(tmp.m1)) sum += *get_begin(tmp.m1);
-    }
-    auto time = t.stop();
-    std::cout << "bisecting_search sum" << sum << ' ' << time << description << std::endl;
-  }
-
-  void testPerformance() {
-    typedef std::vector<SumType> V;
-    V v(1000000);
-    std::iota(v.begin(), v.end(), 5);
-
-    auto r0 = make_range(v.begin(), v.end(), NotPresent{});
-    auto r1 = make_range(v.begin(), NotPresent{}, v.size());
-    auto r2 = make_range(v.begin(), v.end(), v.size());
-
-    auto r3 = make_range(make_iterator(v.begin()), make_iterator(v.end()), NotPresent{});
-    auto r4 = make_range(make_iterator(v.begin()), NotPresent{}, v.size());
-    auto r5 = make_range(make_iterator(v.begin()), make_iterator(v.end()), v.size());
-
-    //Warm up the cache
-    sumOver(r0);
-    performanceTest(r0, " Bounded Range");
-    performanceTest(reverse(r0), " Reverse Bounded Range");
-    performanceTest(r3, " Bounded wrapped Range");
-    performanceTest(reverse(r3), " Reverse Bounded wrapped Range");
-
-    performanceTest(r1, " Counted Range");
-    performanceTest(reverse(r1), " Reversed Counted Range");
-    performanceTest(r2, " Bounded and Counted Range");
-    performanceTest(reverse(r2), " Reversed Bounded and Counted Range");
-    performanceTest(r4, " Counted wrapped Range");
-    performanceTest(reverse(r4), " Reversed Counted wrapped Range");
-    performanceTest(r5, " Bounded and Counted wrapped Range");
-    performanceTest(reverse(r5), " Reverse Bounded and Counted wrapped Range");
-
-    performanceTestImpl(std::cref(v), "std::accumulate", "", [](std::reference_wrapper<V const> x) -> SumType { return std::accumulate(x.get().cbegin(), x.get().cend(), SumType(0)); });
-
-    V v2 = v;
-    std::random_shuffle(v2.begin(), v2.end());
-
-    performanceTestPartitionPoint<0>(r1, " Counted Range 0", v2);
-    performanceTestPartitionPoint<8>(r1, " Counted Range 8", v2);
-    performanceTestPartitionPoint<16>(r1, " Counted Range 16", v2);
-    performanceTestPartitionPoint<32>(r1, " Counted Range 32", v2);
-    performanceTestPartitionPoint<64>(r1, " Counted Range 64", v2);
-   }
 
   template<typename Op>
   void forEachRangeRun(Op op) {
@@ -1607,6 +1655,1213 @@ namespace {
     }
   };
 
+  struct TestChunk {
+    template<typename R>
+    void operator()(R r) const {
+      constexpr int n = 7;
+      auto chunks = chunk(r, n);
+      if (is_empty(r)) {
+        assert(is_empty(chunks));
+        return;
+      }
+      assert(6 == get_count(chunks));
+      int expected = 0;
+      while (!is_empty(chunks)) {
+        auto block = deref(get_begin(chunks));
+        assert((expected + n <= count ? n : count - expected) == get_count(block));
+        while (!is_empty(block)) {
+          assert(expected == *get_begin(block));
+          ++expected;
+          block = successor(block);
+        }
+        chunks = successor(chunks);
+      }
+      assert(count == expected);
+    }
+  };
+
+  void testChunk() {
+    constexpr int n = 7;
+    // Random access over the chunks
+    auto chunks = chunk(r11, n);
+    auto first = get_begin(chunks);
+    auto last = get_end(chunks);
+    assert(6 == last - first);
+    assert(35 == *get_begin(first[5]));
+    assert(5 == get_count(first[5]));
+    assert(last == first + 6);
+    assert(first == last - 6);
+    assert(14 == *get_begin(deref(last - 4)));
+    assert(28 == *get_begin(deref(predecessor(predecessor(last)))));
+
+    // Reversed, the short chunk comes first
+    auto reversed = reverse(chunks);
+    assert(5 == get_count(deref(get_begin(reversed))));
+    assert(28 == *get_begin(deref(get_begin(successor(reversed)))));
+
+    // Exact multiple
+    auto exact = chunk(r11, 8);
+    assert(5 == get_count(exact));
+    assert(8 == get_count(deref(get_begin(exact) + 4)));
+    assert(32 == *get_begin(deref(predecessor(get_end(exact)))));
+  }
+
+  struct TestSliding {
+    template<typename R>
+    void operator()(R r) const {
+      constexpr int w = 5;
+      auto windows = sliding(r, w);
+      int sums[count] = {};
+      int mins[count] = {};
+      int maxs[count] = {};
+      auto sumsLeft = sliding_reduce(r, w, Add{}, std::minus<int>{}, Deref{}, make_range(&sums[0], NotPresent{}, count));
+      auto minsLeft = sliding_extremum(r, w, make_derefop(std::less<int>{}), make_range(&mins[0], NotPresent{}, count));
+      auto maxsLeft = sliding_extremum(r, w, make_derefop(std::greater<int>{}), make_range(&maxs[0], NotPresent{}, count));
+      if (is_empty(r)) {
+        assert(is_empty(windows));
+        assert(count == get_count(sumsLeft.m1));
+        assert(count == get_count(minsLeft.m1));
+        assert(count == get_count(maxsLeft.m1));
+        return;
+      }
+      assert(count - w + 1 == get_count(windows));
+      assert(w - 1 == get_count(sumsLeft.m1));
+      assert(w - 1 == get_count(minsLeft.m1));
+      assert(w - 1 == get_count(maxsLeft.m1));
+      int i = 0;
+      while (!is_empty(windows)) {
+        auto window = deref(get_begin(windows));
+        assert(w == get_count(window));
+        assert(i == *get_begin(window));
+        assert(sums[i] == reduce(window, Add{}, Deref{}, 0).m0);
+        assert(mins[i] == i);
+        assert(maxs[i] == i + w - 1);
+        windows = successor(windows);
+        ++i;
+      }
+      assert(count - w + 1 == i);
+    }
+  };
+
+  void testSliding() {
+    int arr[] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+    constexpr int n = sizeof(arr)/sizeof(arr[0]);
+    constexpr int w = 3;
+    int mins[n - w + 1] = {};
+    int maxs[n - w + 1] = {};
+    std::forward_list<int> l(&arr[0], &arr[0] + n);
+    sliding_extremum(make_range(l.begin(), l.end(), NotPresent{}), w, make_derefop(std::less<int>{}), make_range(&mins[0], NotPresent{}, n - w + 1));
+    sliding_extremum(make_range(l.begin(), l.end(), NotPresent{}), w, make_derefop(std::greater<int>{}), make_range(&maxs[0], NotPresent{}, n - w + 1));
+    for (int i = 0; i != n - w + 1; ++i) {
+      assert(mins[i] == *std::min_element(&arr[i], &arr[i] + w));
+      assert(maxs[i] == *std::max_element(&arr[i], &arr[i] + w));
+    }
+
+    // The candidate queue comes from scratch, so repeated scans allocate only for the first
+    {
+      arena scratch;
+      int again[n - w + 1] = {};
+      for (int k = 0; k != 3; ++k) {
+        sliding_extremum(make_range(l.begin(), l.end(), NotPresent{}), w, make_derefop(std::less<int>{}), make_range(&again[0], NotPresent{}, n - w + 1), scratch);
+        assert(std::equal(&mins[0], &mins[0] + (n - w + 1), &again[0]));
+        assert(0 == scratch.stats().bytes_in_use && 1 == scratch.stats().upstream_allocations);
+      }
+      assert(0 != scratch.stats().peak_bytes);
+    }
+
+    // Window larger than the range
+    auto windows = sliding(make_range(&arr[0], NotPresent{}, 2), w);
+    assert(is_empty(windows));
+    auto left = sliding_reduce(make_range(&arr[0], NotPresent{}, 2), w, Add{}, std::minus<int>{}, Deref{}, make_range(&mins[0], NotPresent{}, 1));
+    assert(1 == get_count(left.m1));
+
+    // Random access over windows
+    auto r = add_constant_time_end(sliding(make_range(&arr[0], NotPresent{}, n), w));
+    assert(n - w + 1 == get_end(r) - get_begin(r));
+    assert(9 == *get_begin(get_begin(r)[5]));
+  }
+
+  struct TestPipeline {
+    template<typename R>
+    void operator()(R r) const {
+      auto twice = [](int x) { return 2 * x; };
+      auto multipleOfFour = [](int x) { return 0 == x % 4; };
+      int sum = r | transform(twice) | filter(multipleOfFour) | reduce(Add{}, 0);
+      int all = r | reduce(Add{}, 0);
+      int filtered = r | filter(multipleOfFour) | reduce(Add{}, 0);
+      if (is_empty(r)) {
+        assert(0 == sum);
+        assert(0 == all);
+        assert(0 == filtered);
+      } else {
+        assert(2 * (19 * 20) == sum);
+        assert(39 * 20 == all);
+        assert(4 * (9 * 10 / 2) == filtered);
+      }
+    }
+  };
+
+  void testPipeline() {
+    // Stage order matters and the value type may change along the pipeline.
+    auto half = [](int x) { return x / 2.0; };
+    auto whole = [](double x) { return x == static_cast<int>(x); };
+    double sum = r11 | transform(half) | filter(whole) | reduce(std::plus<double>{}, 0.0);
+    assert(190.0 == sum);
+    int count = r11 | filter([](int x) { return x < 10; }) | transform([](int) { return 1; }) | reduce(Add{}, 0);
+    assert(10 == count);
+  }
+
+  // Creates a temporary file holding n consecutive ints from 0, returning its path.
+  std::string makeTemporaryIntFile(int n) {
+    char path[] = "/tmp/range2_testXXXXXX";
+    int fd = mkstemp(path);
+    assert(-1 != fd);
+    std::vector<int> v(n);
+    std::iota(v.begin(), v.end(), 0);
+    auto written = ::write(fd, v.data(), v.size() * sizeof(int));
+    assert(written == static_cast<ssize_t>(v.size() * sizeof(int)));
+    (void)written;
+    ::close(fd);
+    return path;
+  }
+
+  void testMappedFile() {
+    constexpr int n = 10000;
+    std::string path = makeTemporaryIntFile(n);
+    {
+      mapped_file<int> f(path.c_str());
+      assert(f.is_open());
+      auto r = f.range();
+      assert(n == get_count(r));
+
+      assert(0 == advise_for<ForEach>(f));
+      auto tmp = for_each(r, TestForEachOp::Summation<long long>{0});
+      assert((long long)(n - 1) * n / 2 == tmp.m0.count);
+
+      assert(0 == advise_for<BisectingSearch>(f));
+      int s = 1234;
+      auto found = partition_point(r, make_derefop([&s](int x) { return s <= x; }));
+      assert(1234 == *get_begin(found.m1));
+      assert(1234 == get_count(found.m0));
+
+      // Ownership moves with the mapping
+      mapped_file<int> g(cmove(f));
+      assert(!f.is_open());
+      assert(g.is_open());
+      assert(n == get_count(g.range()));
+    }
+    {
+      mapped_file<int> f(path.c_str(), map_options{true, true});
+      assert(f.is_open());
+      assert(n == get_count(f.range()));
+      assert(0 == f.advise(WillNeedAccess{}));
+    }
+    std::remove(path.c_str());
+
+    std::string empty = makeTemporaryIntFile(0);
+    {
+      mapped_file<int> f(empty.c_str());
+      assert(f.is_open());
+      assert(is_empty(f.range()));
+    }
+    std::remove(empty.c_str());
+
+    mapped_file<int> missing(empty.c_str());
+    assert(!missing.is_open());
+    assert(ENOENT == missing.error());
+    assert(is_empty(missing.range()));
+  }
+
+  void testRecordStreamImpl(std::string const& path, int n, std::size_t recordsPerBuffer, bool readAhead) {
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      record_stream<int> stream(fd, recordsPerBuffer, readAhead);
+      auto tmp = for_each(make_stream_range(stream), TestForEachOp::Summation<long long>{0});
+      assert((long long)(n - 1) * n / 2 == tmp.m0.count);
+      assert(is_empty(tmp.m1));
+      assert(0 == stream.error());
+      ::close(fd);
+    }
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      record_stream<int> stream(fd, recordsPerBuffer, readAhead);
+      assert(n / 2 == count_if(make_stream_range(stream), make_derefop([](int x) { return 0 == (x & 1); }), 0));
+      ::close(fd);
+    }
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      record_stream<int> stream(fd, recordsPerBuffer, readAhead);
+      auto tmp = reduce(make_stream_range(stream), Add{}, Deref{}, 0);
+      assert((n - 1) * n / 2 == tmp.m0);
+      ::close(fd);
+    }
+  }
+
+  void testRecordStream() {
+    constexpr int n = 1000;
+    std::string path = makeTemporaryIntFile(n);
+    testRecordStreamImpl(path, n, 1, false);
+    testRecordStreamImpl(path, n, 7, false);
+    testRecordStreamImpl(path, n, 1000, false);
+    testRecordStreamImpl(path, n, 4096, false);
+    testRecordStreamImpl(path, n, 1, true);
+    testRecordStreamImpl(path, n, 7, true);
+    testRecordStreamImpl(path, n, 1000, true);
+    testRecordStreamImpl(path, n, 4096, true);
+
+    // Single pass algorithms read their input once only
+    {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      record_stream<int> stream(fd, 16, true);
+      auto r = make_stream_range(stream);
+      assert(increasing_range(r, make_derefop(std::less<int>{})));
+      assert(is_empty(r));
+      ::close(fd);
+    }
+    std::remove(path.c_str());
+
+    // Records arriving through a pipe in pieces
+    int fds[2];
+    int rc = pipe(fds);
+    assert(0 == rc);
+    (void)rc;
+    std::thread writer([&fds]() {
+      for (int i = 0; i != n; ++i) {
+        char const* p = reinterpret_cast<char const*>(&i);
+        // Split each record across writes.
+        auto a = ::write(fds[1], p, 1);
+        auto b = ::write(fds[1], p + 1, sizeof(int) - 1);
+        (void)a, (void)b;
+      }
+      ::close(fds[1]);
+    });
+    {
+      record_stream<int> stream(fds[0], 64, true);
+      auto tmp = for_each(make_stream_range(stream), TestForEachOp::Summation<long long>{0});
+      assert((long long)(n - 1) * n / 2 == tmp.m0.count);
+    }
+    writer.join();
+    ::close(fds[0]);
+
+    // An invalid descriptor gives an empty stream and reports the error
+    record_stream<int> bad(-1, 16, false);
+    assert(is_empty(make_stream_range(bad)));
+    assert(EBADF == bad.error());
+  }
+
+  void testWritableMappedFile() {
+    char path[] = "/tmp/range2_testXXXXXX";
+    int fd = mkstemp(path);
+    assert(-1 != fd);
+    ::close(fd);
+    {
+      writable_mapped_file<int> f(path, count);
+      assert(f.is_open());
+      auto out = f.range();
+      assert(count == get_count(out));
+      auto tmp = visit_2_ranges(r11, out, copy_step{});
+      assert(is_empty(tmp.m1));
+      assert(0 == f.flush(split_at(out, NotPresent{}, count / 2).m0));
+      assert(0 == f.flush(true));
+      assert(0 == f.flush());
+    }
+    {
+      mapped_file<int> f(path);
+      assert(f.is_open());
+      assert(lexicographical_equal(f.range(), r11));
+    }
+    {
+      // Merge the evens and odds straight into the file
+      int evens[count / 2];
+      int odds[count / 2];
+      for (int i = 0; i != count / 2; ++i) evens[i] = 2 * i, odds[i] = 2 * i + 1;
+      writable_mapped_file<int> f(path, count, map_options{true, false});
+      assert(f.is_open());
+      visit_3_ranges(make_range(&evens[0], NotPresent{}, count / 2), make_range(&odds[0], NotPresent{}, count / 2), f.range(), make_merge_if(make_derefop(std::less<int>{}), copy_step{}));
+      assert(0 == f.flush());
+      assert(lexicographical_equal(make_range(get_begin(f.range()), NotPresent{}, count - 1), make_range(begin, NotPresent{}, count - 1)));
+    }
+    {
+      writable_mapped_file<int> f(path, 0);
+      assert(f.is_open());
+      assert(is_empty(f.range()));
+      assert(0 == f.flush());
+    }
+    std::remove(path);
+
+    writable_mapped_file<int> missing("/nonexistent_directory/file", count);
+    assert(!missing.is_open());
+    assert(ENOENT == missing.error());
+    assert(is_empty(missing.range()));
+  }
+
+  void testArena() {
+    arena a;
+    assert(0 == a.capacity() && 0 == a.stats().upstream_allocations);
+    double* d = a.allocate_array<double>(3);
+    char* c = static_cast<char*>(a.allocate(1, 1));
+    long long* l = a.allocate_array<long long>(1);
+    assert(0 == reinterpret_cast<std::uintptr_t>(d) % alignof(double) && 0 == reinterpret_cast<std::uintptr_t>(l) % alignof(long long));
+    assert(static_cast<void*>(c) >= static_cast<void*>(d + 3) && static_cast<void*>(l) > static_cast<void*>(c));
+    assert(3 * sizeof(double) + 1 + sizeof(long long) == a.stats().bytes_in_use && 1 == a.stats().upstream_allocations);
+
+    // Padding to the alignment runs past the end of a nearly full block
+    {
+      arena small(10);
+      small.allocate(10, 1);
+      int* x = small.allocate_array<int>(1);
+      *x = 1;
+      assert(2 == small.stats().upstream_allocations && 0 == reinterpret_cast<std::uintptr_t>(x) % alignof(int));
+    }
+
+    // Blocks given up by rewind are reused
+    auto m = a.mark();
+    a.allocate(100000);
+    assert(2 == a.stats().upstream_allocations && a.capacity() > 100000);
+    a.rewind(m);
+    assert(a.capacity() > 100000 && m.bytes_in_use == a.stats().bytes_in_use);
+    a.allocate(100000);
+    assert(2 == a.stats().upstream_allocations);
+    a.rewind(m);
+
+    // Batches of the same size stop allocating once reset has merged the blocks
+    for (int batch = 0; batch != 3; ++batch) {
+      std::vector<int, arena_allocator<int>> v{arena_allocator<int>(a)};
+      for (int i = 0; i != 5000; ++i) v.push_back(i);
+      assert(4999 == v.back());
+      a.reset();
+    }
+    auto const steady = a.stats().upstream_allocations;
+    {
+      std::vector<int, arena_allocator<int>> v{arena_allocator<int>(a)};
+      for (int i = 0; i != 5000; ++i) v.push_back(i);
+    }
+    assert(steady == a.stats().upstream_allocations && 0 != a.stats().bytes_in_use && a.stats().peak_bytes >= a.stats().bytes_in_use);
+    assert(a.stats().total_bytes > 4 * 5000 * sizeof(int));
+    a.release();
+    assert(0 == a.capacity() && 0 == a.stats().bytes_in_use);
+
+    // Each thread has its own arena
+    arena* mine = &thread_arena();
+    arena* other = nullptr;
+    std::thread t([&other]() { other = &thread_arena(); thread_arena().allocate(16); });
+    t.join();
+    assert(mine == &thread_arena() && mine != other && 0 == mine->stats().bytes_in_use);
+  }
+
+  void testExternalSort() {
+    constexpr int n = 10000;
+    std::vector<int> input(n);
+    std::iota(input.begin(), input.end(), 0);
+    std::random_shuffle(input.begin(), input.end());
+    auto less = make_derefop(std::less<int>{});
+
+    // Budgets giving many runs, a few runs and a single in memory sort.
+    std::size_t const budgets[] = {16 * sizeof(int), 1000 * sizeof(int), 3000 * sizeof(int), n * sizeof(int)};
+    for (std::size_t budget : budgets) {
+      std::vector<int> output(n + 1, -1);
+      auto tmp = external_sort(make_range(input.data(), NotPresent{}, n), make_range(output.data(), NotPresent{}, n + 1), less, external_sort_options{budget, "/tmp"});
+      assert(0 == tmp.m0);
+      assert(1 == get_count(tmp.m1));
+      assert(-1 == output[n]);
+      assert(increasing_range(make_range(output.data(), NotPresent{}, n), less));
+      assert(lexicographical_equal(make_range(output.data(), NotPresent{}, count), make_range(begin, NotPresent{}, count)));
+      assert(n - 1 == output[n - 1]);
+    }
+
+    // Working memory is taken from scratch and rewound, so repeated sorts, in memory or
+    // spilling runs, allocate only while scratch grows and then make no heap allocation at all
+    {
+      arena scratch;
+      scratch.allocate(8);
+      std::vector<int> output(n);
+      std::size_t const sortBudgets[] = {n * sizeof(int), 1000 * sizeof(int), 16 * sizeof(int), n * sizeof(int), 1000 * sizeof(int), 16 * sizeof(int)};
+      std::size_t upstream = 0;
+      std::size_t heap = 0;
+      for (std::size_t i = 0; i != sizeof(sortBudgets) / sizeof(sortBudgets[0]); ++i) {
+        if (3 == i) {
+          upstream = scratch.stats().upstream_allocations;
+          heap = heapAllocations;
+        }
+        auto tmp = external_sort(make_range(input.data(), NotPresent{}, n), make_range(output.data(), NotPresent{}, n), less, external_sort_options{sortBudgets[i], "/tmp"}, scratch);
+        assert(0 == tmp.m0 && increasing_range(make_range(output.data(), NotPresent{}, n), less));
+        assert(8 == scratch.stats().bytes_in_use);
+      }
+      assert(upstream == scratch.stats().upstream_allocations);
+      assert(heap == heapAllocations);
+    }
+
+    // Single pass input, descending order, output range shorter than the input.
+    {
+      std::string path = makeTemporaryIntFile(n);
+      int fd = ::open(path.c_str(), O_RDONLY);
+      record_stream<int> stream(fd, 128);
+      std::vector<int> output(count);
+      auto tmp = external_sort(make_stream_range(stream), make_range(output.data(), NotPresent{}, count), make_derefop(std::greater<int>{}), external_sort_options{4096, "/tmp"});
+      assert(0 == tmp.m0);
+      assert(is_empty(tmp.m1));
+      assert(n - 1 == output[0]);
+      assert(n - count == output[count - 1]);
+      ::close(fd);
+      std::remove(path.c_str());
+    }
+
+    // Empty input
+    {
+      int output[1] = {-1};
+      auto tmp = external_sort(make_range(input.data(), NotPresent{}, 0), make_range(&output[0], NotPresent{}, 1), less, external_sort_options{64, "/tmp"});
+      assert(0 == tmp.m0);
+      assert(1 == get_count(tmp.m1));
+    }
+
+    // Runs cannot be created
+    {
+      std::vector<int> output(n);
+      auto tmp = external_sort(make_range(input.data(), NotPresent{}, n), make_range(output.data(), NotPresent{}, n), less, external_sort_options{1024, "/nonexistent_directory"});
+      assert(ENOENT == tmp.m0);
+    }
+  }
+
+  void testCompressedColumn() {
+    typedef unsigned long long Id;
+    constexpr int n = 1000;
+    std::vector<Id> ids(n);
+    Id id = 1ULL << 40;
+    for (int i = 0; i != n; ++i) {
+      ids[i] = id;
+      // Runs of duplicates, small gaps and the occasional large one
+      id += (i % 7 == 0) ? 0 : (i % 101 == 0) ? (1ULL << 35) : Id(i % 13);
+    }
+    compressed_column<Id> column(make_range(ids.begin(), ids.end(), NotPresent{}));
+    assert(n == column.size());
+    assert(column.size_in_bytes() < n * sizeof(Id) / 4);
+    assert((n + 127) / 128 == static_cast<int>(column.index().size()));
+
+    auto r = column.range();
+    assert(n == get_count(r));
+    assert(lexicographical_equal(r, make_range(ids.begin(), ids.end(), NotPresent{})));
+    assert(ids[300] == *column.iterator_at(300));
+    assert(ids[256] == *column.block_begin(2));
+
+    // Searches give the same answers as over the uncompressed values
+    auto less = make_derefop(std::less<Id>{});
+    auto sub = make_range(column.iterator_at(5), NotPresent{}, n - 300);
+    for (int i = 0; i < n; i += 3) {
+      Id const values[] = {ids[i], ids[i] + 1, ids[i] - 1};
+      for (Id v : values) {
+        auto lower = lower_bound_predicate(r, less, v);
+        assert(std::lower_bound(ids.begin(), ids.end(), v) - ids.begin() == get_count(lower.m0));
+        auto upper = upper_bound_predicate(r, less, v);
+        assert(std::upper_bound(ids.begin(), ids.end(), v) - ids.begin() == get_count(upper.m0));
+        auto pp = partition_point(sub, make_derefop([v](Id x) { return !(x < v); }));
+        auto expected = std::lower_bound(ids.begin() + 5, ids.begin() + 5 + (n - 300), v);
+        assert(expected - (ids.begin() + 5) == get_count(pp.m0));
+        if (!is_empty(pp.m1)) assert(*expected == *get_begin(pp.m1));
+        assert(get_count(pp.m0) + get_count(pp.m1) == n - 300);
+      }
+    }
+
+    // Each search decodes the block starts it bisects and the values of at most one block
+    constexpr std::ptrdiff_t B = compressed_column<Id>::block_size;
+    operation_counts counts = {};
+    std::ptrdiff_t scanned = -1;
+    bool oneBlock = true;
+    Id v = 0;
+    auto notLess = make_counting_op([&](compressed_column_iterator<Id> const& x) {
+      if (0 != x.basis.index % B) {
+        if (-1 != scanned && scanned != x.basis.index / B) oneBlock = false;
+        scanned = x.basis.index / B;
+      }
+      return !(*x < v);
+    }, &counts);
+    for (int i = 0; i < n; i += 7) {
+      for (auto const& x : {r, make_range(column.iterator_at(5), column.iterator_at(n - 295), n - 300)}) {
+        counts = operation_counts{}, scanned = -1, v = ids[i] + 1;
+        auto pp = partition_point(x, notLess);
+        assert(get_count(pp.m0) + get_count(pp.m1) == get_count(x));
+        assert(oneBlock);
+        // Bisecting at most 7 block starts, then scanning one block
+        assert(counts.comparisons <= 3 + B);
+      }
+    }
+
+    compressed_column<Id> empty;
+    assert(is_empty(empty.range()));
+    assert(is_empty(partition_point(empty.range(), make_derefop([](Id x) { return x > 0; })).m0));
+  }
+
+  void testBitRange() {
+    // Reference answers come from std::vector<bool>; sizes straddle word boundaries
+    constexpr std::ptrdiff_t n = 1000;
+    std::vector<bool> flags(n);
+    bool plain[n];
+    bit_vector bits;
+    for (std::ptrdiff_t i = 0; i != n; ++i) {
+      flags[i] = (i % 3 == 0) || (i > 500 && i < 700);
+      plain[i] = flags[i];
+      bits.push_back(flags[i]);
+    }
+    auto r = bits.range();
+    assert(n == get_count(r));
+    assert((n + 63) / 64 == static_cast<std::ptrdiff_t>(bits.words().size()));
+    assert(lexicographical_equal(r, make_range(flags.begin(), flags.end(), NotPresent{})));
+
+    for (std::ptrdiff_t first = 0; first < n; first += 37) {
+      for (std::ptrdiff_t m = 0; first + m <= n; m += 29) {
+        auto sub = make_range(get_begin(r) + first, NotPresent{}, m);
+        auto f0 = flags.begin() + first;
+        auto f1 = f0 + m;
+        std::ptrdiff_t set = std::count(f0, f1, true);
+        assert(set == count_if(sub, bit_is_set{}, std::ptrdiff_t(0)));
+        assert(m - set == count_if(sub, bit_is_clear{}, std::ptrdiff_t(0)));
+        assert(std::find(f0, f1, true) - f0 == m - get_count(find_if(sub, bit_is_set{})));
+        assert(std::find(f0, f1, false) - f0 == m - get_count(find_if(sub, bit_is_clear{})));
+        // The generic reduce over bool seeds with the first value and applies the predicate to the rest
+        auto ref = make_range(plain + first, NotPresent{}, m);
+        assert(reduce(ref, std::logical_or<bool>{}, bit_is_set{}, false).m0 == reduce(sub, std::logical_or<bool>{}, bit_is_set{}, false).m0);
+        assert(reduce(ref, std::logical_and<bool>{}, bit_is_set{}, true).m0 == reduce(sub, std::logical_and<bool>{}, bit_is_set{}, true).m0);
+        assert(reduce(ref, std::not_equal_to<bool>{}, bit_is_set{}, false).m0 == reduce(sub, std::not_equal_to<bool>{}, bit_is_set{}, false).m0);
+        assert(reduce(ref, std::logical_or<bool>{}, bit_is_clear{}, false).m0 == reduce(sub, std::logical_or<bool>{}, bit_is_clear{}, false).m0);
+        assert(reduce(ref, std::logical_and<bool>{}, bit_is_clear{}, true).m0 == reduce(sub, std::logical_and<bool>{}, bit_is_clear{}, true).m0);
+        assert(reduce(ref, std::not_equal_to<bool>{}, bit_is_clear{}, false).m0 == reduce(sub, std::not_equal_to<bool>{}, bit_is_clear{}, false).m0);
+        assert((set != 0) == reduce(sub, std::logical_or<bool>{}, bit_is_set{}, false).m0 || 0 == m);
+        assert((set == m) == reduce(sub, std::logical_and<bool>{}, bit_is_set{}, true).m0);
+        assert((set % 2 == 1) == reduce(sub, std::not_equal_to<bool>{}, bit_is_set{}, false).m0);
+        assert(is_empty(reduce(sub, std::logical_or<bool>{}, bit_is_clear{}, false).m1));
+        assert(std::is_partitioned(f0, f1, [](bool x) { return x; }) == partitioned(sub, bit_is_set{}));
+        assert(std::is_partitioned(f0, f1, [](bool x) { return !x; }) == partitioned(sub, bit_is_clear{}));
+      }
+    }
+
+    // A single set bit seeds logical_or, so the predicate on it is not consulted
+    bit_vector one(1, true);
+    assert(reduce(one.range(), std::logical_or<bool>{}, bit_is_clear{}, false).m0);
+    assert(reduce(make_range(plain, NotPresent{}, 1), std::logical_or<bool>{}, bit_is_clear{}, false).m0);
+
+    // Writes go through the proxy reference or sink
+    bit_vector written(130, true);
+    assert(130 == count_if(written.range(), bit_is_set{}, 0));
+    auto w = get_begin(written.range());
+    *(w + 64) = false;
+    sink(w + 129, false);
+    assert(!*(w + 64) && !*(w + 129) && *(w + 128));
+    assert(128 == count_if(written.range(), bit_is_set{}, 0));
+    assert(66 == get_count(find_if(written.range(), bit_is_clear{})));
+    assert(!partitioned(make_range(w + 64, NotPresent{}, 66), bit_is_clear{}));
+    assert(!partitioned(written.range(), bit_is_set{}));
+    assert(partitioned(make_range(w, NotPresent{}, 65), bit_is_set{}));
+  }
+
+  void testByteSearch() {
+    std::string text;
+    for (int i = 0; i != 50; ++i) text += "key" + std::to_string(i) + "=value;\tnext,\n";
+    auto r = make_range(text.data(), text.data() + text.size(), std::ptrdiff_t(text.size()));
+    auto generic = make_range(text.begin(), text.end(), NotPresent{});
+
+    // Single bytes and byte sets agree with the per byte predicates at every start position
+    byte_set delimiters = make_byte_set(";,\t");
+    assert(3 == delimiters.size() && delimiters.contains(',') && !delimiters.contains('='));
+    for (std::ptrdiff_t i = 0; i != get_count(r); ++i) {
+      auto sub = make_range(get_begin(r) + i, get_end(r), get_count(r) - i);
+      auto subGeneric = make_range(text.begin() + i, text.end(), NotPresent{});
+      auto expected = std::find(text.begin() + i, text.end(), '\n') - text.begin();
+      assert(expected == find_if(sub, byte_equal_to{'\n'}).begin - text.data());
+      assert(expected == get_begin(find_if(subGeneric, byte_equal_to{'\n'})) - text.begin());
+      expected = std::find_first_of(text.begin() + i, text.end(), ";,\t", ";,\t" + 3) - text.begin();
+      assert(expected == find_if(sub, make_byte_set_pred(&delimiters)).begin - text.data());
+      assert(expected == get_begin(find_if(subGeneric, make_byte_set_pred(&delimiters))) - text.begin());
+    }
+    assert(is_empty(find_if(r, byte_equal_to{'#'})));
+    byte_set const none;
+    assert(is_empty(find_if(r, make_byte_set_pred(&none))));
+
+    // Substring search, including needles of 0, 1 and 2 bytes and misses
+    char const* needles[] = {"", "k", "=v", "key4", "key49=value;", "key50", "next,\nkey1", "value;\tnexT"};
+    for (char const* needle : needles) {
+      std::ptrdiff_t m = std::strlen(needle);
+      auto expected = std::search(text.begin(), text.end(), needle, needle + m) - text.begin();
+      auto found = search(r, make_range(needle, NotPresent{}, m));
+      auto foundGeneric = search(generic, make_range(needle, needle + m, NotPresent{}));
+      assert(expected == get_begin(found.m0) - text.data());
+      assert(expected == get_begin(foundGeneric.m0) - text.begin());
+      if (expected != static_cast<std::ptrdiff_t>(text.size())) {
+        assert(m == get_count(found.m0) && m == get_count(foundGeneric.m0));
+        assert(lexicographical_equal(found.m0, make_range(needle, NotPresent{}, m)));
+        assert(get_end(found.m0) == get_begin(found.m1));
+        assert(static_cast<std::ptrdiff_t>(text.size()) - expected - m == get_count(found.m1));
+      } else {
+        assert(is_empty(found.m0) && is_empty(found.m1));
+        assert(is_empty(foundGeneric.m0) && is_empty(foundGeneric.m1));
+      }
+    }
+  }
+
+  void testAppendBuffer() {
+    // One pass compaction of the even values
+    append_buffer<int> evens;
+    auto tmp = visit_2_ranges(r11, make_append_range(evens), make_step_if(make_derefop([](int x) { return 0 == (x & 1); }), copy_step{}));
+    assert(is_empty(tmp.m0));
+    assert(count / 2 == get_count(evens.range()));
+    int expected = 0;
+    for_each(evens.range(), make_derefop([&expected](int x) { assert(expected == x); expected += 2; }));
+    assert(count == expected);
+
+    // Growth beyond the initial reservation keeps earlier records
+    constexpr int n = 3 * append_buffer<int>::granule / sizeof(int) + 5;
+    append_buffer<int> all(16);
+    assert(0 == all.size());
+    assert(16 <= all.capacity());
+    for (int i = 0; i != n; ++i) all.push_back(i);
+    assert(std::size_t(n) == all.size());
+    assert(std::size_t(n) <= all.capacity());
+    auto r = all.range();
+    assert(n == get_count(r));
+    assert(0 == *get_begin(r));
+    assert(n - 1 == *predecessor(get_end(r)));
+    int next = 0;
+    assert(is_empty(find_if(r, make_derefop([&next](int x) { return x != next++; }))));
+
+    // Pushing one of its own records as it grows, when the mapping may move
+    append_buffer<int> self(1);
+    self.push_back(7);
+    for (int growths = 0; growths != 4; ) {
+      if (self.size() == self.capacity()) ++growths;
+      self.push_back(get_begin(self.range())[self.size() - 1]);
+    }
+    assert(is_empty(find_if(self.range(), make_derefop([](int x) { return 7 != x; }))));
+
+    append_buffer<int> moved(cmove(all));
+    assert(0 == all.size());
+    assert(std::size_t(n) == moved.size());
+    moved.clear();
+    assert(is_empty(moved.range()));
+  }
+
+  void testPerfCounters() {
+    // Counters may be unavailable (no PMU, perf_event_paranoid) but must then say so
+    perf_counters counters;
+    counters.start();
+    long long sum = 0;
+    for (int i = 0; i != 100000; ++i) sum += i * arr[i % 40];
+    perf_counts counts = counters.stop();
+    assert(0 != sum);
+    if (counts.available(perf_event::instructions)) assert(counts.values[perf_event::instructions] > 100000.0);
+    if (!counters.is_open()) {
+      for (int i = 0; i != perf_event::size; ++i) assert(!counts.available(i));
+      assert(counts.instructions_per_cycle() < 0.0);
+    }
+
+    perf_counters disabled(false);
+    assert(!disabled.is_open());
+    counts = make_zero_perf_counts();
+    counts += disabled.stop();
+    assert(!counts.available(perf_event::cycles));
+  }
+
+  void testCycleTimer() {
+    cycle_timer t;
+    assert(cycle_timer::nanoseconds_per_tick() > 0.0);
+    t.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    double ns = t.stop();
+    assert(ns > 1.5e6 && ns < 1e9);
+    // Back to back readings have the measurement overhead removed
+    t.start();
+    assert(t.stop_ticks() < 10 * cycle_timer::overhead_ticks() + 1000);
+  }
+
+  void testLatencyHistogram() {
+    latency_histogram h;
+    for (std::uint64_t i = 1; i <= 10000; ++i) h.record(i);
+    assert(10000 == h.count() && 1 == h.min() && 10000 == h.max());
+    assert(5000.5 == h.mean());
+    // Small values are exact, large ones within 1/32
+    double const percents[] = {1.0, 50.0, 90.0, 99.0, 99.9};
+    for (double p : percents) {
+      double exact = p * 100.0;
+      auto x = h.percentile(p);
+      assert(x >= exact && x <= exact * (1.0 + 1.0 / 32.0));
+    }
+    assert(10000 == h.percentile(100.0));
+
+    h.clear();
+    assert(0 == h.count());
+    for (std::uint64_t i = 0; i != 64; ++i) h.record(i);
+    assert(31 == h.percentile(50.0));
+    assert(63 == h.percentile(100.0));
+    h.record(~std::uint64_t(0));
+    assert(~std::uint64_t(0) == h.percentile(100.0));
+  }
+
+  // Declared complexities checked against counted operations over sizes 16 to 2^14
+  template<typename C, typename Op>
+  bool meetsComplexity(Op op) {
+    return meets_complexity<C>(op, 16, 1 << 14);
+  }
+
+  void testOperationCounts() {
+    constexpr std::ptrdiff_t maxN = 1 << 14;
+    std::vector<int> v(maxN);
+    std::iota(v.begin(), v.end(), 0);
+    std::forward_list<int> fl(v.begin(), v.end());
+    operation_counts counts = {};
+
+    auto vectorRange = [&](std::ptrdiff_t n) { counts = operation_counts{}; return make_counting_range(make_range(v.begin(), NotPresent{}, n), &counts); };
+    auto listRange = [&](std::ptrdiff_t n) { counts = operation_counts{}; return make_counting_range(make_range(fl.begin(), NotPresent{}, n), &counts); };
+    typedef decltype(vectorRange(0)) VectorRange;
+    typedef decltype(listRange(0)) ListRange;
+
+    // Counting is transparent
+    auto r = vectorRange(40);
+    assert(lexicographical_equal(r, make_range(v.begin(), NotPresent{}, 40)));
+    assert(40 == counts.derefs && 40 == counts.traversals());
+    *get_begin(vectorRange(1)) = 0;
+    assert(1 == counts.derefs);
+
+    // add_linear_time_end
+    auto addEndVector = [&](std::ptrdiff_t n) { add_linear_time_end(vectorRange(n)); return counts.traversals(); };
+    auto addEndList = [&](std::ptrdiff_t n) { add_linear_time_end(listRange(n)); return counts.traversals(); };
+    TEST_ASSERT((std::is_same<ConstantComplexity, Complexity<AddEnd, VectorRange, void>::type>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<AddEnd, ListRange, void>::type>::value));
+    assert((meetsComplexity<Complexity<AddEnd, VectorRange, void>>(addEndVector)));
+    assert((meetsComplexity<Complexity<AddEnd, ListRange, void>>(addEndList)));
+    // The check detects a linear cost where constant is declared
+    assert(!meetsComplexity<ConstantComplexity>(addEndList));
+
+    // reverse
+    auto reverseVector = [&](std::ptrdiff_t n) { reverse(vectorRange(n)); return counts.traversals(); };
+    assert((meetsComplexity<Complexity<Reverse, VectorRange>>(reverseVector)));
+
+    // split_at with a count only
+    auto splitVector = [&](std::ptrdiff_t n) { split_at(vectorRange(n), NotPresent{}, n / 2); return counts.traversals(); };
+    auto splitList = [&](std::ptrdiff_t n) { split_at(listRange(n), NotPresent{}, n / 2); return counts.traversals(); };
+    assert((meetsComplexity<Complexity<Split_At, VectorRange, NotPresent, std::ptrdiff_t>>(splitVector)));
+    assert((meetsComplexity<Complexity<Split_At, ListRange, NotPresent, std::ptrdiff_t>>(splitList)));
+    assert(!meetsComplexity<LogarithmicComplexity>(splitList));
+
+    // chunk costs a traversal only when the source must be counted
+    auto boundedListRange = [&](std::ptrdiff_t n) { counts = operation_counts{}; return make_counting_range(make_range(fl.begin(), std::next(fl.begin(), n), NotPresent{}), &counts); };
+    typedef decltype(boundedListRange(0)) BoundedListRange;
+    auto chunkList = [&](std::ptrdiff_t n) { chunk(listRange(n), 7); return counts.traversals(); };
+    auto chunkBoundedList = [&](std::ptrdiff_t n) { chunk(boundedListRange(n), 7); return counts.traversals(); };
+    TEST_ASSERT((std::is_same<ConstantComplexity, Complexity<Chunk, ListRange>::type>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<Chunk, BoundedListRange>::type>::value));
+    assert((meetsComplexity<Complexity<Chunk, ListRange>>(chunkList)));
+    assert((meetsComplexity<Complexity<Chunk, BoundedListRange>>(chunkBoundedList)));
+    assert(!meetsComplexity<ConstantComplexity>(chunkBoundedList));
+
+    // partition_point makes logarithmically many comparisons, with linear traversal of forward iterators
+    auto lessThanMiddle = [&](std::ptrdiff_t n) { return make_counting_op(make_derefop([n](int x) { return x >= n / 3; }), &counts); };
+    auto searchVector = [&](std::ptrdiff_t n) { auto tmp = vectorRange(n); partition_point(tmp, lessThanMiddle(n)); return counts.comparisons; };
+    auto searchList = [&](std::ptrdiff_t n) { auto tmp = listRange(n); partition_point(tmp, lessThanMiddle(n)); return counts.comparisons; };
+    auto searchListTraversals = [&](std::ptrdiff_t n) { auto tmp = listRange(n); partition_point(tmp, lessThanMiddle(n)); return counts.traversals(); };
+    assert(meetsComplexity<LogarithmicComplexity>(searchVector));
+    assert(meetsComplexity<LogarithmicComplexity>(searchList));
+    assert(meetsComplexity<LinearComplexity>(searchListTraversals));
+    assert(!meetsComplexity<LogarithmicComplexity>(searchListTraversals));
+
+    // find_if
+    auto findVector = [&](std::ptrdiff_t n) { auto tmp = vectorRange(n); find_if(tmp, lessThanMiddle(n)); return counts.total(); };
+    assert(meetsComplexity<LinearComplexity>(findVector));
+    assert(!meetsComplexity<LogarithmicComplexity>(findVector));
+  }
+
+  // Counted repeatable ranges take the unrolled loops; every remainder length must agree with the plain loops
+  void testUnrolled() {
+    TEST_ASSERT((IsInlineable<Range<std::vector<int>::iterator, NotPresent, Present>>::value));
+    TEST_ASSERT((!IsInlineable<Range<std::vector<int>::iterator, Present, NotPresent>>::value));
+    std::vector<std::string> v;
+    for (int i = 0; i != 11; ++i) v.push_back(std::string(1, char('a' + i)));
+    auto concatenate = [](std::string const& x, std::string const& y) { return x + y; };
+    auto deref = make_derefop([](std::string const& x) { return x; });
+    for (std::ptrdiff_t n = 0; n != 11; ++n) {
+      auto counted = make_range(v.begin(), NotPresent{}, n);
+      auto bounded = make_range(v.begin(), v.begin() + n, n);
+      auto plain = make_range(v.begin(), v.begin() + n, NotPresent{});
+      TEST_ASSERT((std::is_same<decltype(counted), decltype(for_each(counted, deref).m1)>::value));
+
+      std::string visited;
+      auto tmp = for_each(counted, make_derefop([&visited](std::string const& x) { visited += x; }));
+      assert(visited == std::accumulate(v.begin(), v.begin() + n, std::string{}));
+      assert(is_empty(tmp.m1) && get_begin(tmp.m1) == v.begin() + n);
+      visited.clear();
+      impl::for_each_unrolled<8>(bounded, make_derefop([&visited](std::string const& x) { visited += x; }));
+      assert(visited == std::accumulate(v.begin(), v.begin() + n, std::string{}));
+
+      // Non commutative, so the grouping must keep the order
+      if (0 != n) {
+        auto reduced = reduce_nonempty(counted, concatenate, deref);
+        assert(reduced.m0 == visited && is_empty(reduced.m1));
+        assert(reduce_nonempty(bounded, concatenate, deref).m0 == reduce_nonempty(plain, concatenate, deref).m0);
+      }
+
+      auto odd = make_derefop([](std::string const& x) { return 0 != (x[0] & 1); });
+      assert(count_if(counted, odd, std::ptrdiff_t(0)) == std::count_if(v.begin(), v.begin() + n, [](std::string const& x) { return 0 != (x[0] & 1); }));
+      assert(count_if(bounded, odd, 3) == count_if(plain, odd, 3));
+
+      for (std::ptrdiff_t i = 0; i <= n; ++i) {
+        std::string const target(1, char('a' + i));
+        auto is = make_derefop([&target](std::string const& x) { return x == target; });
+        auto found = find_if(counted, is);
+        assert(get_begin(found) == v.begin() + i && get_count(found) == n - i);
+        auto foundBounded = find_if(bounded, is);
+        assert(get_begin(foundBounded) == v.begin() + i && get_count(foundBounded) == n - i && get_end(foundBounded) == v.begin() + n);
+      }
+    }
+  }
+
+  struct ConstexprPlus {
+    template<typename T>
+    constexpr T operator()(T x, T y) const { return x + y; }
+  };
+
+  struct ConstexprDeref {
+    template<typename T>
+    constexpr T operator()(T const* x) const { return *x; }
+  };
+
+  struct ConstexprLess {
+    template<typename T>
+    constexpr bool operator()(T const* x, T const* y) const { return *x < *y; }
+  };
+
+  constexpr int fixedData[] = {3, 1, 4, 1, 5, 9, 2, 6};
+
+  void testFixedRange() {
+    constexpr auto r = make_fixed_range<8>(fixedData);
+    TEST_ASSERT(8 == get_count(r) && !is_empty(r));
+    TEST_ASSERT(is_empty(make_fixed_range<0>(fixedData)));
+    TEST_ASSERT((std::is_same<FixedRange<int const*, 7>, decltype(successor(r))>::value));
+    TEST_ASSERT(1 == *get_begin(successor(r)));
+
+    // Counts computed at compile time
+    TEST_ASSERT((std::is_same<FixedRange<int const*, 3>, decltype(split_at<3>(r).m0)>::value));
+    TEST_ASSERT((std::is_same<FixedRange<int const*, 5>, decltype(split_at<3>(r).m1)>::value));
+    TEST_ASSERT((std::is_same<FixedRange<int const*, 4>, decltype(splitInTwo(make_fixed_range<7>(fixedData)).m1)>::value));
+    TEST_ASSERT(5 == *get_begin(splitInTwo(r).m1));
+
+    // Reductions and comparisons evaluated by the compiler
+    TEST_ASSERT(31 == reduce_nonempty(r, ConstexprPlus{}, ConstexprDeref{}).m0);
+    TEST_ASSERT(8 == reduce(split_at<3>(r).m0, ConstexprPlus{}, ConstexprDeref{}, 0).m0);
+    TEST_ASSERT(7 == reduce(make_fixed_range<0>(fixedData), ConstexprPlus{}, ConstexprDeref{}, 7).m0);
+    TEST_ASSERT(fixedData + 8 == get_begin(reduce_nonempty(r, ConstexprPlus{}, ConstexprDeref{}).m1));
+    TEST_ASSERT(lexicographical_compare(make_fixed_range<2>(fixedData + 1), make_fixed_range<3>(fixedData), ConstexprLess{}));
+    TEST_ASSERT(lexicographical_compare(make_fixed_range<2>(fixedData), make_fixed_range<3>(fixedData), ConstexprLess{}));
+    TEST_ASSERT(!lexicographical_compare(make_fixed_range<3>(fixedData), make_fixed_range<2>(fixedData), ConstexprLess{}));
+    TEST_ASSERT(!lexicographical_compare(r, r, ConstexprLess{}));
+    TEST_ASSERT(!lexicographical_compare(make_fixed_range<0>(fixedData), make_fixed_range<0>(fixedData), ConstexprLess{}));
+
+    // Runtime use with ordinary iterators and lambdas
+    std::vector<int> v(fixedData, fixedData + 8);
+    auto fv = make_fixed_range<8>(v.begin());
+    std::vector<int> visited;
+    auto tmp = for_each(fv, make_derefop([&visited](int x) { visited.push_back(x); }));
+    assert(visited == v && get_begin(tmp.m1) == v.end());
+    assert(31 == reduce(fv, std::plus<int>{}, make_derefop([](int x) { return x; }), 0).m0);
+    auto less = make_derefop(std::less<int>{});
+    assert(lexicographical_compare(split_at<4>(fv).m0, split_at<4>(fv).m1, less) == std::lexicographical_compare(v.begin(), v.begin() + 4, v.begin() + 4, v.end()));
+    assert(get_begin(find_if(add_dynamic_count(fv), make_derefop([](int x) { return 9 == x; }))) == v.begin() + 5);
+  }
+
+  // Callable only with pointers, so usable on vector ranges only once lowered
+  struct IsNineAt {
+    bool operator()(int const* x) const { return 9 == *x; }
+  };
+
+  void testContiguous() {
+    typedef std::vector<int> V;
+    TEST_ASSERT(IsContiguousIterator<int*>::value && IsContiguousIterator<V::iterator>::value && IsContiguousIterator<V::const_iterator>::value);
+    TEST_ASSERT(IsContiguousIterator<std::string::iterator>::value);
+    TEST_ASSERT(IsContiguousIterator<decltype(make_iterator(std::declval<V::iterator>()))>::value);
+    TEST_ASSERT(!IsContiguousIterator<std::forward_list<int>::iterator>::value);
+    TEST_ASSERT(!IsContiguousIterator<decltype(make_reverse_iterator<V::iterator>(std::declval<V::iterator>()))>::value);
+
+    V v(fixedData, fixedData + 8);
+    assert(to_address(v.begin() + 2) == &v[2] && to_address(make_iterator(v.begin() + 2)) == &v[2]);
+
+    auto bounded = make_range(v.begin(), v.end(), NotPresent{});
+    auto wrapped = make_range(make_iterator(v.begin()), make_iterator(v.end()), std::ptrdiff_t(8));
+    auto found = find_if(bounded, IsNineAt{});
+    assert(get_begin(found) == v.begin() + 5 && get_end(found) == v.end() && 3 == get_count(found));
+    auto foundWrapped = find_if(wrapped, IsNineAt{});
+    TEST_ASSERT((std::is_same<decltype(wrapped), decltype(foundWrapped)>::value));
+    assert(get_begin(foundWrapped) == make_iterator(v.begin() + 5) && 3 == get_count(foundWrapped));
+    assert(1 == count_if(wrapped, IsNineAt{}, 0));
+
+    // Ops only callable with the original iterators are not lowered
+    assert(get_begin(find_if(bounded, [](V::iterator x) { return 9 == *x; })) == v.begin() + 5);
+
+    auto sum = reduce_nonempty(wrapped, std::plus<int>{}, [](int const* x) { return *x; });
+    assert(31 == sum.m0 && is_empty(sum.m1) && get_begin(sum.m1) == make_iterator(v.end()));
+    int visited = 0;
+    auto each = for_each(bounded, [&visited](int const* x) { visited += *x; });
+    assert(31 == visited && get_begin(each.m1) == v.end() && get_end(each.m1) == v.end());
+
+    // Byte search over string iterators reaches the pointer specialisations
+    std::string text = "split,these;fields";
+    auto t = make_range(text.begin(), text.end(), NotPresent{});
+    assert(get_begin(find_if(t, byte_equal_to{';'})) == text.begin() + 11);
+    auto match = search(t, make_range("these", NotPresent{}, 5));
+    assert(get_begin(match.m0) == text.begin() + 6 && get_end(match.m0) == text.begin() + 11);
+    assert(get_begin(match.m1) == text.begin() + 11 && get_end(match.m1) == text.end() && 7 == get_count(match.m1));
+  }
+
+  void testSizedForwardList() {
+    sized_forward_list<int> q;
+    assert(q.empty() && is_empty(q.range()));
+    for (int i = 1; i != 6; ++i) q.push_back(i);
+    q.push_front(0);
+    assert(6 == q.size() && 0 == q.front() && 5 == q.back() && 6 == get_count(q.range()));
+
+    typedef decltype(q.range()) R;
+    TEST_ASSERT(ConstantTimeCount<R>::value && ConstantTimeEnd<R>::value);
+    TEST_ASSERT((std::is_same<ConstantComplexity, Complexity<AddCount, R, void>::type>::value));
+
+    // Neither the count nor the end is recomputed by walking the list
+    operation_counts counts = {};
+    auto counted = make_counting_range(q.range(), &counts);
+    add_linear_time_count(counted);
+    add_linear_time_end(counted);
+    assert(0 == counts.traversals());
+
+    auto p = partition_point(q.range(), make_derefop([](int x) { return x >= 3; }));
+    assert(3 == get_count(p.m0) && 3 == *get_begin(p.m1) && 3 == get_count(p.m1));
+
+    q.pop_front();
+    q.erase_after(std::next(q.before_begin(), 4));
+    assert(4 == q.size() && 4 == q.back());
+    q.push_back(7);
+    assert(7 == q.back() && 5 == get_count(q.range()));
+
+    sized_forward_list<int> moved(cmove(q));
+    assert(q.empty() && 5 == moved.size() && 7 == moved.back());
+    q.push_back(8);
+    assert(8 == q.front() && 8 == q.back());
+    while (!moved.empty()) moved.pop_front();
+    moved.push_front(9);
+    assert(9 == moved.back() && 1 == get_count(moved.range()));
+    sized_forward_list<int> const copy(moved);
+    assert(lexicographical_equal(copy.range(), moved.range()));
+  }
+
+  void testCheckpointIndex() {
+    std::vector<int> v(300);
+    for (int i = 0; i != 300; ++i) v[i] = i / 3;
+    std::forward_list<int> fl(v.begin(), v.end());
+    auto listRange = make_range(fl.begin(), fl.end(), NotPresent{});
+    auto const less = make_derefop(std::less<int>{});
+
+    std::ptrdiff_t const strides[] = {1, 4, 7, 299, 300, 1000};
+    for (auto stride : strides) {
+      auto index = make_checkpoint_index(listRange, stride);
+      assert(index.checkpoints().size() == std::size_t((300 + stride - 1) / stride));
+      for (int a = -1; a <= 100; ++a) {
+        auto expected = equivalent_range(listRange, less, a);
+        auto found = equivalent_range(index, less, a);
+        assert(get_begin(found.m1) == get_begin(expected.m1) && get_end(found.m1) == get_end(expected.m1));
+        assert(get_count(found.m0) == get_count(expected.m0) && get_count(found.m1) == get_count(expected.m1) && get_count(found.m2) == get_count(expected.m2));
+        assert(get_end(found.m2) == fl.end());
+        auto p = partition_point(index, make_derefop([a](int x) { return x > a; }));
+        assert(get_begin(p.m1) == get_begin(expected.m2) && get_count(p.m1) == get_count(expected.m2));
+        // Over the uncounted list the bounds agree without counting it
+        auto lower = lower_bound_predicate(listRange, less, a);
+        auto upper = upper_bound_predicate(listRange, less, a);
+        assert(get_begin(lower.m1) == get_begin(expected.m1) && get_count(lower.m0) == get_count(expected.m0));
+        assert(get_begin(upper.m1) == get_begin(expected.m2) && get_count(upper.m0) == get_count(expected.m0) + get_count(expected.m1));
+      }
+    }
+
+    auto empty = make_checkpoint_index(make_range(fl.end(), fl.end(), NotPresent{}), 4);
+    assert(empty.checkpoints().empty() && is_empty(partition_point(empty, make_derefop([](int) { return true; })).m1));
+
+    // Once built, a search traverses at most a stride of the list however long it is
+    std::vector<int> w(1 << 14);
+    std::iota(w.begin(), w.end(), 0);
+    std::forward_list<int> sorted(w.begin(), w.end());
+    operation_counts counts = {};
+    auto searchIndexed = [&](std::ptrdiff_t n) {
+      auto index = make_checkpoint_index(make_counting_range(make_range(sorted.begin(), NotPresent{}, n), &counts), 16);
+      counts = operation_counts{};
+      partition_point(index, make_derefop([n](int x) { return x >= n / 3; }));
+      return counts.total();
+    };
+    assert(meetsComplexity<LogarithmicComplexity>(searchIndexed));
+  }
+
+  void testReverseBuffer() {
+    for (int n = 0; n != 40; ++n) {
+      std::vector<int> v(n);
+      std::iota(v.begin(), v.end(), 0);
+      std::forward_list<int> fl(v.begin(), v.end());
+      auto buffer = make_reverse_buffer(make_range(fl.begin(), fl.end(), NotPresent{}));
+      auto r = reverse(buffer);
+      assert(n == get_count(r));
+      assert(lexicographical_equal(r, make_range(v.rbegin(), v.rend(), NotPresent{})));
+    }
+
+    std::vector<int> v(10);
+    std::iota(v.begin(), v.end(), 0);
+    std::forward_list<int> fl(v.begin(), v.end());
+    auto buffer = make_reverse_buffer(make_range(fl.begin(), NotPresent{}, 10));
+    assert(4 == buffer.stride());
+    auto r = reverse(buffer);
+    auto found = find_if(r, make_derefop([](int x) { return x < 6; }));
+    assert(5 == *get_begin(found) && 6 == get_count(found));
+    // Writable through the reversed range
+    *get_begin(successor(r)) = 80;
+    assert(80 == *std::next(fl.begin(), 8));
+
+    // O(n) successors in all, and O(sqrt(n)) iterators held
+    std::vector<int> w(1 << 14);
+    std::forward_list<int> list(w.begin(), w.end());
+    operation_counts counts = {};
+    auto reverseList = [&](std::ptrdiff_t n) {
+      counts = operation_counts{};
+      auto b = make_reverse_buffer(make_counting_range(make_range(list.begin(), NotPresent{}, n), &counts));
+      for_each(reverse(b), [](decltype(get_begin(reverse(b)))) {});
+      assert(b.stride() * b.stride() >= n && (b.stride() - 1) * (b.stride() - 1) < n);
+      return counts.traversals();
+    };
+    assert(meetsComplexity<LinearComplexity>(reverseList));
+  }
+
+  // Indices of the first and one past the last element of a subrange; combining checks neighbours are adjacent
+  struct Span {
+    std::ptrdiff_t first;
+    std::ptrdiff_t last;
+  };
+
+  struct CombineAdjacent {
+    Span operator()(Span x, Span y) const {
+      assert(x.last == y.first);
+      return {x.first, y.last};
+    }
+  };
+
+  void testTaskScheduler() {
+    std::vector<int> v(1 << 18);
+    std::iota(v.begin(), v.end(), 0);
+    int const* base = v.data();
+    auto r = make_range(v.data(), NotPresent{}, std::ptrdiff_t(v.size()));
+    typedef Range<int*, NotPresent, Present> Leaf;
+    auto span = [base](Leaf x) { return Span{get_begin(x) - base, get_begin(x) - base + get_count(x)}; };
+
+    unsigned const threadCounts[] = {1, 2, 4};
+    for (unsigned threads : threadCounts) {
+      task_scheduler s(task_scheduler_options{threads, 2 == threads});
+      assert(threads == s.thread_count());
+
+      std::ptrdiff_t const grains[] = {1000, 4096, 1 << 18};
+      for (auto grain : grains) {
+        auto whole = fork_join(s, r, span, CombineAdjacent{}, grain);
+        assert(0 == whole.first && std::ptrdiff_t(v.size()) == whole.last);
+      }
+
+      long long const expected = std::accumulate(v.begin(), v.end(), 0LL);
+      auto sum = fork_join(s, r, [](Leaf x) { return std::accumulate(get_begin(x), get_begin(x) + get_count(x), 0LL); }, std::plus<long long>{});
+      assert(expected == sum);
+      assert(int(v.size() - 1) == reduce(s, r, [](int x, int y) { return x < y ? y : x; }, make_derefop([](int x) { return x; }), 0));
+
+      std::vector<int> w(v.size());
+      for_each(s, make_range(w.begin(), w.end(), NotPresent{}), [](std::vector<int>::iterator x) { *x = 1; });
+      assert(std::ptrdiff_t(w.size()) == std::accumulate(w.begin(), w.end(), std::ptrdiff_t(0)));
+
+      // Nested fork_join from within leaves
+      auto nested = fork_join(s, make_range(v.data(), NotPresent{}, std::ptrdiff_t(8)), [&](Leaf x) {
+        return fork_join(s, make_range(v.data() + 1024 * (get_begin(x) - base), NotPresent{}, std::ptrdiff_t(1024)), span, CombineAdjacent{}, 16).first;
+      }, std::plus<std::ptrdiff_t>{}, 1);
+      assert(1024 * 28 == nested);
+
+      // Small ranges stay on the calling thread
+      auto caller = std::this_thread::get_id();
+      assert(caller == fork_join(s, make_range(v.data(), NotPresent{}, std::ptrdiff_t(100)), [](Leaf) { return std::this_thread::get_id(); }, [](std::thread::id x, std::thread::id) { return x; }));
+
+      // Callers outside the pool take turns as worker 0
+      std::vector<std::thread> callers;
+      std::atomic<int> correct(0);
+      for (int i = 0; i != 3; ++i) {
+        callers.emplace_back([&]() {
+          if (std::ptrdiff_t(v.size()) == fork_join(s, r, span, CombineAdjacent{}, 512).last) ++correct;
+        });
+      }
+      for (auto& x : callers) x.join();
+      assert(3 == correct);
+
+      // Scratch a task takes from its worker's arena is freed when the task returns
+      std::size_t const callerBytes = thread_arena().stats().bytes_in_use;
+      bool fresh = fork_join(s, r, [](Leaf x) {
+        arena& a = thread_arena();
+        bool fresh = 0 == task_scheduler::current().index || 0 == a.stats().bytes_in_use;
+        a.allocate_array<int>(std::size_t(get_count(x)));
+        return fresh;
+      }, std::logical_and<bool>{}, 4096);
+      assert(fresh);
+      assert(callerBytes == thread_arena().stats().bytes_in_use);
+    }
+  }
+
+  void testCostPlans() {
+    TEST_ASSERT((std::is_same<LinearComplexity, SequentialComplexity<ConstantComplexity, LinearComplexity, LogarithmicComplexity>::type>::value));
+    TEST_ASSERT((std::is_same<UndefinedComplexity, SequentialComplexity<UndefinedComplexity, LinearComplexity>::type>::value));
+
+    std::vector<int> v(100);
+    std::iota(v.begin(), v.end(), 0);
+    std::forward_list<int> fl(v.begin(), v.end());
+    typedef decltype(make_range(v.begin(), NotPresent{}, 10)) CountedVector;
+    typedef decltype(make_range(fl.begin(), NotPresent{}, 10)) CountedList;
+    typedef decltype(make_range(fl.begin(), fl.end(), NotPresent{})) BoundedList;
+
+    // Reversing a counted forward range must first find its end
+    TEST_ASSERT((std::is_same<ConstantComplexity, Complexity<Reverse, CountedVector>::setup>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<Reverse, CountedList>::setup>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<Join, CountedVector, CountedList>::type>::value));
+    TEST_ASSERT((std::is_same<ConstantComplexity, Complexity<AddCount, CountedList, void>::type>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<AddCount, BoundedList, void>::type>::value));
+
+    // A bounded forward haystack is not counted, only the needle
+    TEST_ASSERT((std::is_same<ConstantComplexity, Complexity<Search, BoundedList, CountedVector>::setup>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<Search, BoundedList, BoundedList>::setup>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<Search, BoundedList, CountedVector>::type>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<Lexicographical_Equivalent, BoundedList, CountedVector>::type>::value));
+    auto p = make_range(v.begin(), NotPresent{}, 10) | transform([](int x) { return x + 1; });
+    TEST_ASSERT((std::is_same<ConstantComplexity, Complexity<Reduce_Pipeline, decltype(p)>::setup>::value));
+    assert(55 == (p | reduce(std::plus<int>{}, 0)));
+
+    operation_counts counts = {};
+    auto haystack = make_counting_range(make_range(fl.begin(), fl.end(), NotPresent{}), &counts);
+    int const needle[] = {3, 4, 5};
+    auto found = search(haystack, make_range(needle, NotPresent{}, 3));
+    assert(3 == *get_begin(found.m0) && 3 == get_count(found.m0) && 6 == *get_begin(found.m1));
+    // Found without a pass over the 100 elements to count them first
+    assert(counts.successors < 20);
+    int const absent[] = {98, 99, 100};
+    found = search(haystack, make_range(absent, NotPresent{}, 3));
+    assert(is_empty(found.m0) && is_empty(found.m1));
+    assert(get_begin(found.m0) == make_counting_iterator(fl.end(), &counts));
+    int const tail[] = {98, 99};
+    found = search(haystack, make_range(tail, NotPresent{}, 2));
+    assert(98 == *get_begin(found.m0) && is_empty(found.m1));
+
+    // partition_point bisects where the count is free and otherwise searches forward uncounted
+    TEST_ASSERT((std::is_same<ConstantComplexity, Complexity<Partition_Point, BoundedList>::setup>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<Partition_Point, BoundedList>::traversal>::value));
+    TEST_ASSERT((std::is_same<LinearComplexity, Complexity<Partition_Point, CountedList>::type>::value));
+    TEST_ASSERT((std::is_same<LogarithmicComplexity, Complexity<Partition_Point, CountedVector>::type>::value));
+    auto uncounted = partition_point(make_range(fl.begin(), fl.end(), NotPresent{}), make_derefop([](int) { return true; }));
+    TEST_ASSERT((std::is_same<BoundedList, decltype(uncounted.m1)>::value));
+    assert(0 == get_count(uncounted.m0));
+    counts = operation_counts{};
+    auto point = partition_point(haystack, make_derefop([](int x) { return x >= 5; }));
+    assert(5 == get_count(point.m0) && 5 == *get_begin(point.m1));
+    assert(counts.successors < 20);
+    for (int a = -1; a <= 100; ++a) {
+      auto tmp = partition_point(haystack, make_derefop([a](int x) { return x >= a; }));
+      int const expected = a < 0 ? 0 : a;
+      assert(expected == get_count(tmp.m0));
+      assert(get_begin(tmp.m1) == make_counting_iterator(std::next(fl.begin(), expected), &counts));
+    }
+  }
+
   void testSteps() {
     const int arri[] = {0, 1};
     int arro[] = {2, 3};
@@ -1749,10 +3004,12 @@ int main() {
   testIterator();
   testReversedIterator();
   testSkipIterator();
+  testRuntimeSkipIterator();
 
   testReverse();
   testSkip();
   testReverseSkip();
+  testRuntimeSkip();
 
   forEachRangeRun(TestForEachOp{});
   forEachRangeRun(TestFindIfOp{});
@@ -1775,9 +3032,35 @@ int main() {
   testLexicographicalLess();
   forEachRangeRun(TestLexicographicalLess{});
 
+  forEachRangeRun(TestChunk{});
+  testChunk();
+  forEachRangeRun(TestSliding{});
+  testSliding();
+  forEachRangeRun(TestPipeline{});
+  testPipeline();
+  testMappedFile();
+  testRecordStream();
+  testWritableMappedFile();
+  testAppendBuffer();
+  testArena();
+  testExternalSort();
+  testCompressedColumn();
+  testBitRange();
+  testByteSearch();
+  testPerfCounters();
+  testCycleTimer();
+  testLatencyHistogram();
+  testOperationCounts();
+  testCostPlans();
+  testUnrolled();
+  testFixedRange();
+  testContiguous();
+  testSizedForwardList();
+  testCheckpointIndex();
+  testReverseBuffer();
+  testTaskScheduler();
+
   testSteps();
   testVisit2Ranges();
   testVisit3Ranges();
-
-  testPerformance();
 }
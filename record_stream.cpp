@@ -0,0 +1 @@
+#include "record_stream.h"
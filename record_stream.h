@@ -0,0 +1,248 @@
+#ifndef INCLUDED_RECORD_STREAM
+#define INCLUDED_RECORD_STREAM
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_CERRNO
+#define INCLUDED_CERRNO
+#include <cerrno>
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+#ifndef INCLUDED_CONDITION_VARIABLE
+#define INCLUDED_CONDITION_VARIABLE
+#include <condition_variable>
+#endif
+
+#ifndef INCLUDED_MUTEX
+#define INCLUDED_MUTEX
+#include <mutex>
+#endif
+
+#ifndef INCLUDED_THREAD
+#define INCLUDED_THREAD
+#include <thread>
+#endif
+
+#ifndef INCLUDED_UTILITY
+#define INCLUDED_UTILITY
+#include <utility>
+#endif
+
+#ifndef INCLUDED_VECTOR
+#define INCLUDED_VECTOR
+#include <vector>
+#endif
+
+#ifndef INCLUDED_UNISTD
+#define INCLUDED_UNISTD
+#include <unistd.h>
+#endif
+
+namespace range2 {
+
+namespace impl {
+
+struct TYPE_HIDDEN_VISIBILITY fill_result
+{
+  std::size_t bytes;
+  int err;
+};
+
+// Reads until the buffer is full, end of file or an error. Looping makes pipes and sockets,
+// which return short reads, deliver whole records except at end of file.
+INLINE fill_result fill_buffer(int fd, char* buffer, std::size_t length) {
+  std::size_t total = 0;
+  while (total != length) {
+    ssize_t n = ::read(fd, buffer + total, length - total);
+    if (n > 0) {
+      total += std::size_t(n);
+    } else if (0 == n) {
+      break;
+    } else if (EINTR != errno) {
+      return {total, errno};
+    }
+  }
+  return {total, 0};
+}
+
+} // namespace impl
+
+// Single pass source of fixed width records of type T read from a file descriptor (a file,
+// pipe or socket) through a reusable buffer. With read_ahead a second buffer is filled by a
+// reader thread, started once for the stream's life, while the first is consumed. That pays only
+// when another core is free to run the reader.
+// The buffer may instead be supplied by the caller, for streams without read_ahead.
+// The descriptor is not owned. Iterators refer to the stream, so it can be neither copied nor moved.
+// A read failure ends the stream early with error() returning the errno value; a trailing
+// partial record is not returned.
+template<typename T>
+class TYPE_DEFAULT_VISIBILITY record_stream
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Records are read directly from the descriptor");
+
+  int fd;
+  bool read_ahead;
+  bool ended;
+  int err;
+  // Buffers owned by the stream, unless the caller supplied one
+  std::vector<T> storage;
+  std::size_t records;
+  T* current;
+  T* next;
+  T const* position;
+  T const* last;
+  // Hand off of next between the consumer and the reader: pending is set while next is the
+  // reader's to fill, and the reader clears it with the result.
+  std::mutex m;
+  std::condition_variable cv;
+  bool pending;
+  bool stopping;
+  impl::fill_result result;
+  std::thread reader;
+
+  ALWAYS_INLINE_HIDDEN impl::fill_result fill(T* buffer) {
+    return impl::fill_buffer(fd, reinterpret_cast<char*>(buffer), records * sizeof(T));
+  }
+
+  void read_loop() {
+    std::unique_lock<std::mutex> lock(m);
+    for (;;) {
+      cv.wait(lock, [this]() { return pending || stopping; });
+      if (stopping) return;
+      lock.unlock();
+      auto tmp = fill(next);
+      lock.lock();
+      result = tmp;
+      pending = false;
+      // The consumer is the only other waiter, and waits only while pending is set.
+      cv.notify_one();
+    }
+  }
+
+  ALWAYS_INLINE_HIDDEN void start_read_ahead() {
+    if (read_ahead && !ended) {
+      {
+        std::lock_guard<std::mutex> lock(m);
+        pending = true;
+      }
+      cv.notify_one();
+    }
+  }
+
+  INLINE impl::fill_result wait_read_ahead() {
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait(lock, [this]() { return !pending; });
+    return result;
+  }
+
+  INLINE void accept(impl::fill_result x) {
+    err = x.err;
+    ended = (0 != x.err) || (x.bytes != records * sizeof(T));
+    position = current;
+    last = position + x.bytes / sizeof(T);
+  }
+
+  INLINE void refill() {
+    if (ended) {
+      position = last = current;
+      return;
+    }
+    if (read_ahead) {
+      auto tmp = wait_read_ahead();
+      std::swap(current, next);
+      accept(tmp);
+    } else {
+      accept(fill(current));
+    }
+    start_read_ahead();
+  }
+
+public:
+  explicit record_stream(int fd, std::size_t records_per_buffer = std::size_t(1) << 16, bool read_ahead = false)
+    : fd(fd), read_ahead(read_ahead), ended(false), err(0), storage(read_ahead ? 2 * records_per_buffer : records_per_buffer), records(records_per_buffer), current(storage.data()), next(read_ahead ? current + records_per_buffer : nullptr), position(nullptr), last(nullptr), m(), cv(), pending(false), stopping(false), result(), reader() {
+    // Precondition records_per_buffer > 0
+    accept(fill(current));
+    if (read_ahead && !ended) reader = std::thread(&record_stream::read_loop, this);
+    start_read_ahead();
+  }
+
+  // Reads through buffer, which must outlive the stream, allocating nothing.
+  record_stream(int fd, T* buffer, std::size_t records_per_buffer)
+    : fd(fd), read_ahead(false), ended(false), err(0), storage(), records(records_per_buffer), current(buffer), next(nullptr), position(nullptr), last(nullptr), m(), cv(), pending(false), stopping(false), result(), reader() {
+    // Precondition records_per_buffer > 0
+    accept(fill(current));
+  }
+
+  record_stream(record_stream const&) = delete;
+  record_stream& operator=(record_stream const&) = delete;
+
+  // Stops the reader once any fill in progress completes.
+  ~record_stream() {
+    if (reader.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(m);
+        stopping = true;
+      }
+      cv.notify_one();
+      reader.join();
+    }
+  }
+
+  ALWAYS_INLINE_HIDDEN bool empty() const { return position == last; }
+
+  ALWAYS_INLINE_HIDDEN T const& front() const { return *position; }
+
+  ALWAYS_INLINE_HIDDEN void pop() {
+    ++position;
+    if (INTROSPECTION_UNLIKELY(position == last)) refill();
+  }
+
+  ALWAYS_INLINE_HIDDEN int error() const { return err; }
+};
+
+
+template<typename T>
+struct TYPE_DEFAULT_VISIBILITY record_stream_iterator_basis {
+  // Every exhausted stream compares equal to the end iterator.
+  typedef record_stream<T>* state_type;
+  state_type stream;
+  typedef T value_type;
+  typedef T const& reference;
+  typedef T const* pointer;
+  typedef std::ptrdiff_t difference_type;
+  typedef std::input_iterator_tag iterator_category;
+
+  friend ALWAYS_INLINE_HIDDEN
+  reference deref(record_stream_iterator_basis const& x) { return x.stream->front(); }
+
+  // Consumes the current record, invalidating every other copy of the iterator.
+  friend ALWAYS_INLINE_HIDDEN
+  record_stream_iterator_basis successor(record_stream_iterator_basis const& x) {
+    x.stream->pop();
+    return x;
+  }
+
+  friend ALWAYS_INLINE_HIDDEN
+  state_type state(record_stream_iterator_basis const& x) { return (nullptr == x.stream || x.stream->empty()) ? nullptr : x.stream; }
+};
+
+template<typename T>
+using record_stream_iterator = iterator<record_stream_iterator_basis<T>>;
+
+// Bounded single pass Range over the records remaining in the stream.
+template<typename T>
+ALWAYS_INLINE_HIDDEN Range<record_stream_iterator<T>, Present, NotPresent>
+make_stream_range(record_stream<T>& x) {
+  return make_range(record_stream_iterator<T>{{&x}}, record_stream_iterator<T>{{nullptr}}, NotPresent{});
+}
+
+} // namespace range2
+
+#endif
@@ -0,0 +1 @@
+#include "reverse_buffer.h"
@@ -0,0 +1,116 @@
+#ifndef INCLUDED_REVERSE_BUFFER
+#define INCLUDED_REVERSE_BUFFER
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_CHECKPOINT_INDEX
+#include "checkpoint_index.h"
+#endif
+
+#ifndef INCLUDED_CMATH
+#define INCLUDED_CMATH
+#include <cmath>
+#endif
+
+#ifndef INCLUDED_VECTOR
+#define INCLUDED_VECTOR
+#include <vector>
+#endif
+
+namespace range2 {
+
+// State for traversing a counted forward range, e.g. over a std::forward_list, backwards.
+// The start of every block of about sqrt(n) elements is recorded in one walk; when traversal
+// moves into a block, the block is walked again to record its iterators. A full reverse
+// traversal therefore makes about 2n successors and holds about 2 sqrt(n) iterators, rather
+// than all n.
+template<typename Rng>
+class TYPE_DEFAULT_VISIBILITY reverse_buffer
+{
+public:
+  typedef RangeIterator<Rng> iterator;
+  typedef RangeDifferenceType<Rng> difference_type;
+
+private:
+  checkpoint_index<Rng> index;
+  // Iterators of block loaded, or of no block if loaded is -1
+  mutable std::vector<iterator> block;
+  mutable difference_type loaded;
+
+  static ALWAYS_INLINE_HIDDEN difference_type block_length(difference_type n) {
+    return 0 == n ? 1 : difference_type(std::ceil(std::sqrt(double(n))));
+  }
+
+  INLINE void load(difference_type b) const {
+    auto n = std::min(index.stride(), get_count(index.range()) - b * index.stride());
+    block.clear();
+    auto tmp = make_range(index.checkpoints()[b], NotPresent{}, n);
+    block.push_back(get_begin(tmp));
+    for (tmp = successor(tmp); !is_empty(tmp); tmp = successor(tmp)) block.push_back(get_begin(tmp));
+    loaded = b;
+  }
+
+public:
+  explicit reverse_buffer(Rng r) : index(r, block_length(get_count(r))), block(), loaded(-1) {
+    block.reserve(index.stride());
+  }
+
+  ALWAYS_INLINE_HIDDEN Rng const& range() const { return index.range(); }
+
+  ALWAYS_INLINE_HIDDEN difference_type stride() const { return index.stride(); }
+
+  // Iterator to the element i from the start of range(); precondition 0 <= i < count.
+  ALWAYS_INLINE_HIDDEN iterator const& at(difference_type i) const {
+    auto b = i / index.stride();
+    if (INTROSPECTION_UNLIKELY(b != loaded)) load(b);
+    return block[i - b * index.stride()];
+  }
+};
+
+template<typename Range>
+ALWAYS_INLINE_HIDDEN auto make_reverse_buffer(Range r) -> reverse_buffer<decltype( add_linear_time_count(r) )> {
+  static_assert(IsAFiniteRange<Range>::value, "Must be a finite range to reverse it");
+  return reverse_buffer<decltype( add_linear_time_count(r) )>(add_linear_time_count(r));
+}
+
+
+// Iterates backwards over the range of a reverse_buffer, position being the number of elements
+// yet to be visited.
+template<typename Rng>
+struct TYPE_DEFAULT_VISIBILITY reverse_buffer_iterator_basis {
+  typedef RangeDifferenceType<Rng> state_type;
+  state_type position;
+  typedef RangeValue<Rng> value_type;
+  typedef Reference<RangeIterator<Rng>> reference;
+  typedef Pointer<RangeIterator<Rng>> pointer;
+  typedef RangeDifferenceType<Rng> difference_type;
+  typedef std::forward_iterator_tag iterator_category;
+  reverse_buffer<Rng> const* buffer;
+
+  friend ALWAYS_INLINE_HIDDEN
+  reference deref(reverse_buffer_iterator_basis const& x) { return deref(x.buffer->at(x.position - 1)); }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  reverse_buffer_iterator_basis successor(reverse_buffer_iterator_basis const& x) { return {x.position - 1, x.buffer}; }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  state_type state(reverse_buffer_iterator_basis const& x) { return x.position; }
+};
+
+template<typename Rng>
+using reverse_buffer_iterator = iterator<reverse_buffer_iterator_basis<Rng>>;
+
+// Range over the elements of x.range() from last to first, valid while x is. A full traversal
+// is O(n); traversals interleaved at distant positions reload blocks and cost more.
+template<typename Rng>
+ALWAYS_INLINE_HIDDEN Range<reverse_buffer_iterator<Rng>, Present, Present>
+reverse(reverse_buffer<Rng> const& x) {
+  auto n = get_count(x.range());
+  return make_range(reverse_buffer_iterator<Rng>{{n, &x}}, reverse_buffer_iterator<Rng>{{0, &x}}, n);
+}
+
+} // namespace range2
+
+#endif
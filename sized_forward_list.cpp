@@ -0,0 +1 @@
+#include "sized_forward_list.h"
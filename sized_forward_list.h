@@ -0,0 +1,142 @@
+#ifndef INCLUDED_SIZED_FORWARD_LIST
+#define INCLUDED_SIZED_FORWARD_LIST
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_FORWARD_LIST
+#define INCLUDED_FORWARD_LIST
+#include <forward_list>
+#endif
+
+#ifndef INCLUDED_ITERATOR
+#define INCLUDED_ITERATOR
+#include <iterator>
+#endif
+
+#ifndef INCLUDED_MEMORY
+#define INCLUDED_MEMORY
+#include <memory>
+#endif
+
+#ifndef INCLUDED_UTILITY
+#define INCLUDED_UTILITY
+#include <utility>
+#endif
+
+namespace range2 {
+
+// std::forward_list that keeps its size and last node as it is modified, so it can be used as
+// a queue and its range() has both end and count present. Algorithms needing a count or an
+// end, e.g. partition_point, then skip the linear walk add_linear_time_count or
+// add_linear_time_end would otherwise make on every call.
+// Only the operations that can maintain the size and last node in constant time are provided.
+template<typename T, typename Allocator = std::allocator<T>>
+class TYPE_DEFAULT_VISIBILITY sized_forward_list
+{
+  typedef std::forward_list<T, Allocator> list_type;
+
+public:
+  typedef typename list_type::iterator iterator;
+  typedef typename list_type::const_iterator const_iterator;
+  typedef DifferenceType<iterator> difference_type;
+
+private:
+  list_type list;
+  // before_begin() when empty
+  iterator last;
+  difference_type size_;
+
+  template<InputIterator I>
+  ALWAYS_INLINE_HIDDEN void append(I first, I end) {
+    for (; first != end; ++first) push_back(*first);
+  }
+
+  ALWAYS_INLINE_HIDDEN void steal(sized_forward_list& x) {
+    list = cmove(x.list);
+    last = (0 == x.size_) ? list.before_begin() : x.last;
+    size_ = x.size_;
+    x.last = x.list.before_begin(), x.size_ = 0;
+  }
+
+public:
+  ALWAYS_INLINE_HIDDEN sized_forward_list() : list(), last(list.before_begin()), size_(0) {}
+
+  template<InputIterator I>
+  ALWAYS_INLINE_HIDDEN sized_forward_list(I first, I end) : sized_forward_list() {
+    append(first, end);
+  }
+
+  ALWAYS_INLINE_HIDDEN sized_forward_list(sized_forward_list const& x) : sized_forward_list(x.list.begin(), x.list.end()) {}
+
+  ALWAYS_INLINE_HIDDEN sized_forward_list(sized_forward_list&& x) : sized_forward_list() {
+    steal(x);
+  }
+
+  ALWAYS_INLINE_HIDDEN sized_forward_list& operator=(sized_forward_list const& x) {
+    if (this != &x) {
+      clear();
+      append(x.list.begin(), x.list.end());
+    }
+    return *this;
+  }
+
+  ALWAYS_INLINE_HIDDEN sized_forward_list& operator=(sized_forward_list&& x) {
+    if (this != &x) steal(x);
+    return *this;
+  }
+
+  ALWAYS_INLINE_HIDDEN difference_type size() const { return size_; }
+
+  ALWAYS_INLINE_HIDDEN bool empty() const { return 0 == size_; }
+
+  ALWAYS_INLINE_HIDDEN T& front() { return list.front(); }
+  ALWAYS_INLINE_HIDDEN T const& front() const { return list.front(); }
+
+  ALWAYS_INLINE_HIDDEN T& back() { return *last; }
+  ALWAYS_INLINE_HIDDEN T const& back() const { return *last; }
+
+  ALWAYS_INLINE_HIDDEN iterator before_begin() { return list.before_begin(); }
+
+  ALWAYS_INLINE_HIDDEN void push_front(T const& x) {
+    list.push_front(x);
+    if (0 == size_) last = list.begin();
+    ++size_;
+  }
+
+  ALWAYS_INLINE_HIDDEN void push_back(T const& x) {
+    last = list.insert_after(last, x);
+    ++size_;
+  }
+
+  ALWAYS_INLINE_HIDDEN void pop_front() {
+    list.pop_front();
+    --size_;
+    if (0 == size_) last = list.before_begin();
+  }
+
+  // Removes the element after x, which may be the last.
+  ALWAYS_INLINE_HIDDEN iterator erase_after(iterator x) {
+    if (std::next(x) == last) last = x;
+    --size_;
+    return list.erase_after(x);
+  }
+
+  ALWAYS_INLINE_HIDDEN void clear() {
+    list.clear();
+    last = list.before_begin(), size_ = 0;
+  }
+
+  ALWAYS_INLINE_HIDDEN Range<iterator, Present, Present> range() {
+    return make_range(list.begin(), list.end(), size_);
+  }
+
+  ALWAYS_INLINE_HIDDEN Range<const_iterator, Present, Present> range() const {
+    return make_range(list.cbegin(), list.cend(), size_);
+  }
+};
+
+} // namespace range2
+
+#endif
@@ -0,0 +1 @@
+#include "task_scheduler.h"
@@ -0,0 +1,454 @@
+#ifndef INCLUDED_TASK_SCHEDULER
+#define INCLUDED_TASK_SCHEDULER
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHMS
+#include "algorithms.h"
+#endif
+
+#ifndef INCLUDED_ARENA
+#include "arena.h"
+#endif
+
+#ifndef INCLUDED_ATOMIC
+#define INCLUDED_ATOMIC
+#include <atomic>
+#endif
+
+#ifndef INCLUDED_CONDITION_VARIABLE
+#define INCLUDED_CONDITION_VARIABLE
+#include <condition_variable>
+#endif
+
+#ifndef INCLUDED_CSTDDEF
+#define INCLUDED_CSTDDEF
+#include <cstddef>
+#endif
+
+#ifndef INCLUDED_MEMORY
+#define INCLUDED_MEMORY
+#include <memory>
+#endif
+
+#ifndef INCLUDED_MUTEX
+#define INCLUDED_MUTEX
+#include <mutex>
+#endif
+
+#ifndef INCLUDED_NEW
+#define INCLUDED_NEW
+#include <new>
+#endif
+
+#ifndef INCLUDED_THREAD
+#define INCLUDED_THREAD
+#include <thread>
+#endif
+
+#ifndef INCLUDED_VECTOR
+#define INCLUDED_VECTOR
+#include <vector>
+#endif
+
+#ifdef __linux__
+#ifndef INCLUDED_PTHREAD
+#define INCLUDED_PTHREAD
+#include <pthread.h>
+#endif
+#endif
+
+namespace range2 {
+
+namespace impl {
+
+// Unit of work in a worker's deque. Tasks live in the frame of the fork that pushed them,
+// which waits for done before returning.
+struct TYPE_HIDDEN_VISIBILITY task
+{
+  void (*execute)(task*);
+  std::atomic<bool> done;
+};
+
+// Chase-Lev deque (as corrected for weak memory models by Le, Pop, Cohen and Zappa Nardelli):
+// the owning worker pushes and pops at the bottom, thieves take from the top.
+// Outgrown arrays are kept until destruction as a thief may still be reading them.
+class TYPE_HIDDEN_VISIBILITY work_stealing_deque
+{
+  struct circular_array {
+    std::ptrdiff_t mask;
+    std::unique_ptr<std::atomic<task*>[]> slots;
+
+    explicit circular_array(std::ptrdiff_t size) : mask(size - 1), slots(new std::atomic<task*>[size]) {}
+
+    ALWAYS_INLINE_HIDDEN std::ptrdiff_t size() const { return mask + 1; }
+    ALWAYS_INLINE_HIDDEN task* get(std::ptrdiff_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+    ALWAYS_INLINE_HIDDEN void put(std::ptrdiff_t i, task* x) { slots[i & mask].store(x, std::memory_order_relaxed); }
+  };
+
+  std::atomic<std::ptrdiff_t> top;
+  std::atomic<std::ptrdiff_t> bottom;
+  std::atomic<circular_array*> array;
+  std::vector<std::unique_ptr<circular_array>> arrays;
+
+  INLINE circular_array* grow(circular_array* a, std::ptrdiff_t b, std::ptrdiff_t t) {
+    arrays.emplace_back(new circular_array(2 * a->size()));
+    circular_array* bigger = arrays.back().get();
+    for (std::ptrdiff_t i = t; i != b; ++i) bigger->put(i, a->get(i));
+    array.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+
+public:
+  explicit work_stealing_deque(std::ptrdiff_t initial_size = 64) : top(0), bottom(0), array(nullptr), arrays() {
+    // Precondition initial_size is a power of two
+    arrays.emplace_back(new circular_array(initial_size));
+    array.store(arrays.back().get(), std::memory_order_relaxed);
+  }
+
+  work_stealing_deque(work_stealing_deque const&) = delete;
+  work_stealing_deque& operator=(work_stealing_deque const&) = delete;
+
+  // Owner only
+  ALWAYS_INLINE_HIDDEN void push(task* x) {
+    std::ptrdiff_t b = bottom.load(std::memory_order_relaxed);
+    std::ptrdiff_t t = top.load(std::memory_order_acquire);
+    circular_array* a = array.load(std::memory_order_relaxed);
+    if (INTROSPECTION_UNLIKELY(b - t > a->size() - 1)) a = grow(a, b, t);
+    a->put(b, x);
+    // Publishes x (and the task it points to) to a thief's acquire of bottom
+    bottom.store(b + 1, std::memory_order_release);
+  }
+
+  // Owner only; nullptr if empty or the last task was stolen.
+  ALWAYS_INLINE_HIDDEN task* pop() {
+    std::ptrdiff_t b = bottom.load(std::memory_order_relaxed) - 1;
+    circular_array* a = array.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::ptrdiff_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    task* x = a->get(b);
+    if (t == b) {
+      // Last task: race thieves for it
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) x = nullptr;
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return x;
+  }
+
+  // Any thread; nullptr if empty or another thread took the task first.
+  ALWAYS_INLINE_HIDDEN task* steal() {
+    std::ptrdiff_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::ptrdiff_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+    task* x = array.load(std::memory_order_acquire)->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) return nullptr;
+    return x;
+  }
+
+  ALWAYS_INLINE_HIDDEN bool maybe_empty() const {
+    return bottom.load(std::memory_order_seq_cst) <= top.load(std::memory_order_seq_cst);
+  }
+};
+
+} // namespace impl
+
+struct TYPE_DEFAULT_VISIBILITY task_scheduler_options
+{
+  // Workers including the calling thread; 0 for one per hardware thread.
+  unsigned threads;
+  // Pin background worker i to CPU i, on Linux.
+  bool pin_threads;
+};
+
+// Execution context for the parallel algorithms: a fixed set of worker threads, each with a
+// work-stealing deque, parked on a condition variable while there is nothing to steal.
+// A thread outside the pool calling in runs as worker 0, so a scheduler of one thread runs
+// everything on the caller; such calls from different threads are serialised.
+// Memory a fork_join leaf takes from thread_arena() is freed when the leaf returns, and a
+// background worker resets its arena between tasks.
+// Tasks must not throw.
+class TYPE_DEFAULT_VISIBILITY task_scheduler
+{
+public:
+  struct TYPE_HIDDEN_VISIBILITY worker_slot {
+    task_scheduler* scheduler;
+    std::size_t index;
+  };
+
+  // The scheduler and worker the calling thread is running as, if any.
+  static INLINE worker_slot& current() {
+    static thread_local worker_slot x = {nullptr, 0};
+    return x;
+  }
+
+private:
+  std::vector<std::unique_ptr<impl::work_stealing_deque>> deques;
+  std::vector<std::thread> threads;
+  std::mutex external;
+  std::mutex park;
+  std::condition_variable wake;
+  std::atomic<unsigned> sleepers;
+  std::atomic<bool> stopping;
+
+  INLINE impl::task* find_task(std::size_t i) {
+    impl::task* x = deques[i]->pop();
+    for (std::size_t k = 1; nullptr == x && k != deques.size(); ++k) x = deques[(i + k) % deques.size()]->steal();
+    return x;
+  }
+
+  INLINE bool any_task() const {
+    for (auto const& d : deques) if (!d->maybe_empty()) return true;
+    return false;
+  }
+
+  INLINE void work(std::size_t i) {
+    current() = {this, i};
+    while (!stopping.load(std::memory_order_acquire)) {
+      impl::task* x = find_task(i);
+      if (nullptr != x) {
+        x->execute(x);
+        thread_arena().reset();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(park);
+      sleepers.fetch_add(1, std::memory_order_seq_cst);
+      // Paired with the fence in fork: a push either sees this sleeper and notifies under
+      // park, or is seen here.
+      if (!stopping.load(std::memory_order_seq_cst) && !any_task()) wake.wait(lock);
+      sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  static INLINE void pin(std::thread& x, unsigned cpu) {
+#ifdef __linux__
+    unsigned cpus = std::thread::hardware_concurrency();
+    if (0 == cpus) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % cpus, &set);
+    pthread_setaffinity_np(x.native_handle(), sizeof(set), &set);
+#else
+    (void)x, (void)cpu;
+#endif
+  }
+
+public:
+  explicit task_scheduler(task_scheduler_options options = task_scheduler_options{0, false}) : deques(), threads(), external(), park(), wake(), sleepers(0), stopping(false) {
+    unsigned n = 0 != options.threads ? options.threads : std::thread::hardware_concurrency();
+    if (0 == n) n = 1;
+    for (unsigned i = 0; i != n; ++i) deques.emplace_back(new impl::work_stealing_deque);
+    for (unsigned i = 1; i != n; ++i) {
+      threads.emplace_back([this, i]() { work(i); });
+      if (options.pin_threads) pin(threads.back(), i);
+    }
+  }
+
+  task_scheduler(task_scheduler const&) = delete;
+  task_scheduler& operator=(task_scheduler const&) = delete;
+
+  ~task_scheduler() {
+    {
+      std::lock_guard<std::mutex> lock(park);
+      stopping.store(true, std::memory_order_seq_cst);
+    }
+    wake.notify_all();
+    for (auto& x : threads) x.join();
+  }
+
+  ALWAYS_INLINE_HIDDEN std::size_t thread_count() const { return deques.size(); }
+
+  // Makes x available to idle workers; called on worker current().index.
+  ALWAYS_INLINE_HIDDEN void fork(impl::task* x) {
+    deques[current().index]->push(x);
+    // push's store to bottom is only a release, which the load of sleepers could otherwise
+    // pass; with the fence, a worker going to sleep either is counted here or sees the task.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (0 != sleepers.load(std::memory_order_seq_cst)) {
+      std::lock_guard<std::mutex> lock(park);
+      wake.notify_one();
+    }
+  }
+
+  // Runs x here unless it has been stolen, in which case runs other tasks until it is done.
+  ALWAYS_INLINE_HIDDEN void join(impl::task* x) {
+    std::size_t i = current().index;
+    impl::task* mine = deques[i]->pop();
+    if (mine == x) {
+      x->execute(x);
+      return;
+    }
+    // Own deque is empty down to x, so pop could only have failed.
+    while (!x->done.load(std::memory_order_acquire)) {
+      impl::task* other = find_task(i);
+      if (nullptr != other) other->execute(other);
+      else std::this_thread::yield();
+    }
+  }
+
+  // Runs f() as worker 0 if the calling thread is not already a worker of this scheduler.
+  template<typename F>
+  INLINE auto run(F f) -> decltype( f() ) {
+    if (this == current().scheduler) return f();
+    std::lock_guard<std::mutex> lock(external);
+    struct restore {
+      worker_slot previous;
+      ~restore() { current() = previous; }
+    } r = {current()};
+    current() = {this, 0};
+    return f();
+  }
+};
+
+namespace impl {
+
+// Subranges reaching the leaf function are counted and carry no end.
+template<typename Iterator>
+using ForkJoinRange = Range<Iterator, NotPresent, Present>;
+
+// Rewinds the thread's arena on leaving a leaf. Leaves may run nested within another leaf
+// waiting at a join, so the arena is rewound rather than reset.
+struct TYPE_HIDDEN_VISIBILITY leaf_arena_scope
+{
+  arena& scratch;
+  arena::mark_type start;
+
+  ~leaf_arena_scope() { scratch.rewind(start); }
+};
+
+template<typename Leaf, typename Rng>
+ALWAYS_INLINE_HIDDEN auto apply_leaf(Leaf& leaf, Rng r) -> decltype( leaf(r) ) {
+  leaf_arena_scope scope = {thread_arena(), thread_arena().mark()};
+  return leaf(r);
+}
+
+template<typename Iterator, typename Leaf, typename Combine>
+INLINE auto fork_join_recurse(task_scheduler& s, ForkJoinRange<Iterator> r, Leaf& leaf, Combine& combine, DifferenceType<Iterator> grain) -> decltype( leaf(r) );
+
+template<typename Iterator, typename Leaf, typename Combine, typename Result>
+struct TYPE_HIDDEN_VISIBILITY fork_join_task : task
+{
+  task_scheduler* scheduler;
+  ForkJoinRange<Iterator> range;
+  Leaf* leaf;
+  Combine* combine;
+  DifferenceType<Iterator> grain;
+  typename std::aligned_storage<sizeof(Result), alignof(Result)>::type result;
+
+  static INLINE void apply(task* x) {
+    fork_join_task* self = static_cast<fork_join_task*>(x);
+    new (&self->result) Result(fork_join_recurse(*self->scheduler, self->range, *self->leaf, *self->combine, self->grain));
+    self->done.store(true, std::memory_order_release);
+  }
+
+  ALWAYS_INLINE_HIDDEN Result take() {
+    Result* p = reinterpret_cast<Result*>(&result);
+    Result tmp = cmove(*p);
+    p->~Result();
+    return tmp;
+  }
+};
+
+template<typename Iterator, typename Leaf, typename Combine>
+INLINE auto fork_join_recurse(task_scheduler& s, ForkJoinRange<Iterator> r, Leaf& leaf, Combine& combine, DifferenceType<Iterator> grain) -> decltype( leaf(r) ) {
+  typedef decltype( leaf(r) ) Result;
+  if (get_count(r) <= grain) return apply_leaf(leaf, r);
+  auto halves = splitInTwo(r);
+  fork_join_task<Iterator, Leaf, Combine, Result> right;
+  right.execute = &fork_join_task<Iterator, Leaf, Combine, Result>::apply;
+  right.done.store(false, std::memory_order_relaxed);
+  right.scheduler = &s, right.range = halves.m1, right.leaf = &leaf, right.combine = &combine, right.grain = grain;
+  s.fork(&right);
+  Result left = fork_join_recurse(s, remove_end(halves.m0), leaf, combine, grain);
+  s.join(&right);
+  return combine(cmove(left), right.take());
+}
+
+// Enough leaves for each worker to steal several, but no fewer than 2048 elements in each,
+// so that small ranges are not split at all.
+template<typename Difference>
+ALWAYS_INLINE_HIDDEN Difference default_grain(Difference n, std::size_t threads) {
+  Difference x = n / Difference(8 * threads);
+  return x < 2048 ? Difference(2048) : x;
+}
+
+} // namespace impl
+
+// Splits r with splitInTwo until subranges have at most grain elements, applies leaf to each
+// on whichever worker takes it, and combines the results of neighbouring subranges in order
+// with combine, which must be associative. A range of at most grain elements is given to leaf
+// on the calling thread without involving the workers.
+// leaf takes a Range<Iterator, NotPresent, Present>. Splitting forward ranges advances through
+// them, so random access ranges are the ones that gain.
+template<typename Rng, typename Leaf, typename Combine>
+INLINE auto fork_join(task_scheduler& s, Rng r, Leaf leaf, Combine combine, RangeDifferenceType<Rng> grain)
+  -> decltype( leaf(remove_end(add_linear_time_count(r))) ) {
+  static_assert(IsAFiniteRange<Rng>::value, "Must be a finite range");
+  // Precondition grain > 0
+  auto x = remove_end(add_linear_time_count(r));
+  if (get_count(x) <= grain) return impl::apply_leaf(leaf, x);
+  return s.run([&]() { return impl::fork_join_recurse(s, x, leaf, combine, grain); });
+}
+
+template<typename Rng, typename Leaf, typename Combine>
+INLINE auto fork_join(task_scheduler& s, Rng r, Leaf leaf, Combine combine)
+  -> decltype( leaf(remove_end(add_linear_time_count(r))) ) {
+  auto x = remove_end(add_linear_time_count(r));
+  return fork_join(s, x, cmove(leaf), cmove(combine), impl::default_grain(get_count(x), s.thread_count()));
+}
+
+namespace impl {
+
+template<typename Op, typename Func, typename Value>
+struct TYPE_HIDDEN_VISIBILITY reduce_leaf
+{
+  Op op;
+  Func f;
+  Value z;
+
+  template<typename Rng>
+  ALWAYS_INLINE_HIDDEN Value operator()(Rng x) { return reduce(x, op, f, z).m0; }
+};
+
+template<typename Op>
+struct TYPE_HIDDEN_VISIBILITY for_each_leaf
+{
+  Op op;
+
+  template<typename Rng>
+  ALWAYS_INLINE_HIDDEN NotPresent operator()(Rng x) {
+    for_each(x, op);
+    return {};
+  }
+};
+
+struct TYPE_HIDDEN_VISIBILITY ignore_results
+{
+  ALWAYS_INLINE_HIDDEN NotPresent operator()(NotPresent, NotPresent) const { return {}; }
+};
+
+} // namespace impl
+
+// reduce over the workers of s. z must be an identity of op as each leaf starts from it, and
+// only the value is returned as the range is consumed entirely.
+template<typename Rng, typename Op, typename Func>
+INLINE RangeValue<Rng> reduce(task_scheduler& s, Rng r, Op op, Func f, RangeValue<Rng> const& z) {
+  return fork_join(s, r, impl::reduce_leaf<Op, Func, RangeValue<Rng>>{op, f, z}, op);
+}
+
+// for_each over the workers of s; each leaf applies its own copy of op, in no particular order.
+template<typename Rng, typename Op>
+INLINE void for_each(task_scheduler& s, Rng r, Op op) {
+  fork_join(s, r, impl::for_each_leaf<Op>{op}, impl::ignore_results{});
+}
+
+} // namespace range2
+
+#endif
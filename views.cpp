@@ -0,0 +1 @@
+#include "views.h"
@@ -0,0 +1,281 @@
+#ifndef INCLUDED_VIEWS
+#define INCLUDED_VIEWS
+
+#ifndef INCLUDED_RANGE2
+#include "range2.h"
+#endif
+
+#ifndef INCLUDED_ALGORITHMS
+#include "algorithms.h"
+#endif
+
+#ifndef INCLUDED_ARENA
+#include "arena.h"
+#endif
+
+#ifndef INCLUDED_NEW
+#define INCLUDED_NEW
+#include <new>
+#endif
+
+namespace range2 {
+
+// Iterates over consecutive blocks of n elements of a counted range, the last block holding
+// the remainder. Each block is returned by value as a bounded and counted Range.
+template <InputIterator I>
+struct TYPE_DEFAULT_VISIBILITY chunk_iterator_basis {
+  typedef I state_type;
+  state_type position;
+  typedef Range<I, Present, Present> value_type;
+  typedef value_type reference;
+  typedef value_type const* pointer;
+  typedef DifferenceType<I> difference_type;
+  typedef IteratorCategory<I> iterator_category;
+  // Number of elements before position; a multiple of n except at the end of the source.
+  difference_type consumed;
+  difference_type count;
+  difference_type n;
+
+  static constexpr ALWAYS_INLINE_HIDDEN
+  difference_type chunk_length(chunk_iterator_basis const& x) { return (x.count - x.consumed) < x.n ? (x.count - x.consumed) : x.n; }
+
+  static constexpr ALWAYS_INLINE_HIDDEN
+  difference_type chunk_index(chunk_iterator_basis const& x) { return (x.consumed + x.n - 1) / x.n; }
+
+  static constexpr ALWAYS_INLINE_HIDDEN
+  difference_type chunk_start(chunk_iterator_basis const& x, difference_type index) { return (index * x.n) < x.count ? (index * x.n) : x.count; }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  reference deref(chunk_iterator_basis const& x) { return make_range(x.position, range2::advance(x.position, chunk_length(x)), chunk_length(x)); }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  chunk_iterator_basis successor(chunk_iterator_basis const& x) { return {range2::advance(x.position, chunk_length(x)), x.consumed + chunk_length(x), x.count, x.n}; }
+
+  // Only the final chunk may be short, so the previous chunk starts at the previous multiple of n.
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  chunk_iterator_basis predecessor(chunk_iterator_basis const& x) { return {range2::advance(x.position, ((x.consumed - 1) / x.n) * x.n - x.consumed), ((x.consumed - 1) / x.n) * x.n, x.count, x.n}; }
+
+  // for random access iterator
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  chunk_iterator_basis offset(chunk_iterator_basis const& x, difference_type i) { return {x.position + (chunk_start(x, chunk_index(x) + i) - x.consumed), chunk_start(x, chunk_index(x) + i), x.count, x.n}; }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  difference_type difference(chunk_iterator_basis const& x, chunk_iterator_basis const& y) { return chunk_index(x) - chunk_index(y); }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  state_type state(chunk_iterator_basis const& x) { return x.position; }
+};
+
+template<InputIterator I>
+using chunk_iterator = iterator<chunk_iterator_basis<I>>;
+
+template<InputIterator I>
+constexpr ALWAYS_INLINE_HIDDEN chunk_iterator<I> make_chunk_iterator(I x, DifferenceType<I> consumed, DifferenceType<I> count, DifferenceType<I> n) {
+  return {{x, consumed, count, n}};
+}
+
+namespace impl {
+
+template<typename Iterator>
+constexpr ALWAYS_INLINE_HIDDEN NotPresent make_chunk_end(Range<Iterator, NotPresent, Present> const&, DifferenceType<Iterator>) {
+  return {};
+}
+
+template<typename Iterator>
+constexpr ALWAYS_INLINE_HIDDEN chunk_iterator<Iterator> make_chunk_end(Range<Iterator, Present, Present> const& x, DifferenceType<Iterator> n) {
+  return make_chunk_iterator(get_end(x), get_count(x), get_count(x), n);
+}
+
+template<typename Iterator, typename End>
+constexpr ALWAYS_INLINE_HIDDEN auto
+chunk_impl(Range<Iterator, End, Present> const& x, DifferenceType<Iterator> n) -> decltype( make_range(make_chunk_iterator(get_begin(x), 0, get_count(x), n), make_chunk_end(x, n), (get_count(x) + n - 1) / n) ) {
+  return make_range(make_chunk_iterator(get_begin(x), 0, get_count(x), n), make_chunk_end(x, n), (get_count(x) + n - 1) / n);
+}
+
+} // namespace impl
+
+// Range of the blocks [0, n), [n, 2n) ... of x, the last block being shorter if n does not divide the count.
+// Random access if the source is random access.
+template<typename Range>
+ALWAYS_INLINE_HIDDEN auto
+chunk(Range x, RangeDifferenceType<Range> n) -> decltype( impl::chunk_impl(add_linear_time_count(x), n) ) {
+  static_assert(IsAFiniteRange<Range>::value, "Must be a finite range");
+  static_assert(RepeatableRange<Range>::value, "Each chunk is traversed when formed and again when stepped over so the range must be multipass");
+  // Precondition n > 0
+  return impl::chunk_impl(add_linear_time_count(x), n);
+}
+
+// Forming the chunks only costs the count of the source.
+struct TYPE_HIDDEN_VISIBILITY Chunk { typedef Chunk type; };
+
+template<typename Iterator, typename End, typename Count>
+struct TYPE_HIDDEN_VISIBILITY Complexity<Chunk, Range<Iterator, End, Count>> : if_<ConstantTimeCount<Range<Iterator, End, Count>>::value, ConstantComplexity, LinearComplexity> {};
+
+
+// Iterates over the windows [i, i+w) of a range. Only two iterators are held, so stepping
+// is constant time even for forward iterators. last is the final element of the window rather
+// than one beyond it, so that stepping off the final window never steps beyond the source's end.
+template <InputIterator I>
+struct TYPE_DEFAULT_VISIBILITY sliding_iterator_basis {
+  typedef I state_type;
+  state_type position;
+  typedef Range<I, Present, Present> value_type;
+  typedef value_type reference;
+  typedef value_type const* pointer;
+  typedef DifferenceType<I> difference_type;
+  typedef IteratorCategory<I> iterator_category;
+  state_type last;
+  difference_type w;
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  reference deref(sliding_iterator_basis const& x) { return make_range(x.position, range2::successor(x.last), x.w); }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  sliding_iterator_basis successor(sliding_iterator_basis const& x) { return {range2::successor(x.position), range2::successor(x.last), x.w}; }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  sliding_iterator_basis predecessor(sliding_iterator_basis const& x) { return {range2::predecessor(x.position), range2::predecessor(x.last), x.w}; }
+
+  // for random access iterator
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  sliding_iterator_basis offset(sliding_iterator_basis const& x, difference_type i) { return {x.position + i, x.last + i, x.w}; }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  difference_type difference(sliding_iterator_basis const& x, sliding_iterator_basis const& y) { return std::distance(y.position, x.position); }
+
+  friend constexpr ALWAYS_INLINE_HIDDEN
+  state_type state(sliding_iterator_basis const& x) { return x.position; }
+};
+
+template<InputIterator I>
+using sliding_iterator = iterator<sliding_iterator_basis<I>>;
+
+template<InputIterator I>
+constexpr ALWAYS_INLINE_HIDDEN sliding_iterator<I> make_sliding_iterator(I position, I last, DifferenceType<I> w) {
+  return {{position, last, w}};
+}
+
+namespace impl {
+
+template<typename Iterator, typename End>
+ALWAYS_INLINE_HIDDEN Range<sliding_iterator<Iterator>, NotPresent, Present>
+sliding_impl(Range<Iterator, End, Present> const& x, DifferenceType<Iterator> w) {
+  // Avoid advancing past the end of a range too short to hold a single window.
+  if (get_count(x) < w) return make_range(make_sliding_iterator(get_begin(x), get_begin(x), w), NotPresent{}, 0);
+  return make_range(make_sliding_iterator(get_begin(x), range2::advance(get_begin(x), w - 1), w), NotPresent{}, get_count(x) - w + 1);
+}
+
+} // namespace impl
+
+// Range of the count - w + 1 windows of w consecutive elements of x.
+// The end is not computed; use add_constant_time_end if the source is random access.
+template<typename Range>
+ALWAYS_INLINE_HIDDEN auto
+sliding(Range x, RangeDifferenceType<Range> w) -> decltype( impl::sliding_impl(add_linear_time_count(x), w) ) {
+  static_assert(IsAFiniteRange<Range>::value, "Must be a finite range");
+  static_assert(RepeatableRange<Range>::value, "Windows overlap so the range must be multipass");
+  // Precondition w > 0
+  return impl::sliding_impl(add_linear_time_count(x), w);
+}
+
+
+// Applies f to each element and writes op-reduction of each window of w elements to o,
+// removing the element leaving the window with inv rather than recomputing the window.
+// Requires inv(op(a, b), b) == a, making the whole reduction O(n) rather than O(n*w).
+template<typename Rng, typename Op, typename InverseOp, typename Func, typename OutRange>
+INLINE pair<Rng, OutRange>
+sliding_reduce_impl(Rng r, RangeDifferenceType<Rng> w, Op op, InverseOp inv, Func f, OutRange o) {
+  if (is_empty(r) || is_empty(o)) return range2::make_pair(r, o);
+  auto trail = r;
+  auto acc = f(get_begin(r));
+  r = successor(r);
+  for (RangeDifferenceType<Rng> i = 1; i < w; ++i) {
+    if (is_empty(r)) return range2::make_pair(r, o);
+    acc = op(acc, f(get_begin(r)));
+    r = successor(r);
+  }
+  sink(get_begin(o), acc);
+  o = successor(o);
+  while (!is_empty(r) && !is_empty(o)) {
+    acc = op(inv(acc, f(get_begin(trail))), f(get_begin(r)));
+    trail = successor(trail), r = successor(r);
+    sink(get_begin(o), acc);
+    o = successor(o);
+  }
+  return range2::make_pair(r, o);
+}
+
+template<typename Rng, typename Op, typename InverseOp, typename Func, typename OutRange>
+ALWAYS_INLINE_HIDDEN auto sliding_reduce(Rng r, RangeDifferenceType<Rng> w, Op op, InverseOp inv, Func f, OutRange o) -> decltype( sliding_reduce_impl(add_constant_time_count(r), w, op, inv, f, add_constant_time_count(o)) ) {
+  static_assert(RepeatableRange<Rng>::value, "Windows overlap so the range must be multipass");
+  // Precondition w > 0
+  return sliding_reduce_impl(add_constant_time_count(r), w, op, inv, f, add_constant_time_count(o));
+}
+
+
+namespace impl {
+
+// Fixed capacity double ended queue over uninitialised storage; a monotonic queue never holds
+// more than a window. Elements are constructed on push and destroyed on pop or clear.
+template<typename T>
+struct TYPE_HIDDEN_VISIBILITY ring_buffer
+{
+  T* buffer;
+  std::size_t capacity;
+  std::size_t first;
+  std::size_t size;
+
+  ALWAYS_INLINE_HIDDEN T& front() { return buffer[first]; }
+  ALWAYS_INLINE_HIDDEN T& back() { return buffer[(first + size - 1) % capacity]; }
+  ALWAYS_INLINE_HIDDEN void pop_front() { front().~T(), first = (first + 1) % capacity, --size; }
+  ALWAYS_INLINE_HIDDEN void pop_back() { back().~T(), --size; }
+  ALWAYS_INLINE_HIDDEN void push_back(T x) { ::new (static_cast<void*>(buffer + (first + size) % capacity)) T(cmove(x)), ++size; }
+  ALWAYS_INLINE_HIDDEN void clear() { while (0 != size) pop_back(); }
+};
+
+} // namespace impl
+
+// Writes the extremum of each window of w elements to o: the minimum for a less-than relation,
+// the maximum for greater-than. Keeps a monotonic queue of candidate iterators, each element
+// entering and leaving it at most once, so the whole scan is O(n). The queue of w candidates is
+// taken from scratch and rewound before returning.
+template<typename Rng, typename Rel, typename OutRange>
+INLINE pair<Rng, OutRange>
+sliding_extremum_impl(Rng r, RangeDifferenceType<Rng> w, Rel rel, OutRange o, arena& scratch) {
+  typedef RangeDifferenceType<Rng> D;
+  typedef pair<RangeIterator<Rng>, D> Candidate;
+  auto start = scratch.mark();
+  impl::ring_buffer<Candidate> candidates = {scratch.allocate_array<Candidate>(std::size_t(w)), std::size_t(w), 0, 0};
+  D i = 0;
+  while (!is_empty(r) && !is_empty(o)) {
+    if (candidates.size != 0 && candidates.front().m1 + w == i) candidates.pop_front();
+    // Candidates never better than the new element can never be reported.
+    while (candidates.size != 0 && !rel(candidates.back().m0, get_begin(r))) candidates.pop_back();
+    candidates.push_back(range2::make_pair(get_begin(r), i));
+    r = successor(r), ++i;
+    if (i >= w) {
+      sink(get_begin(o), deref(candidates.front().m0));
+      o = successor(o);
+    }
+  }
+  candidates.clear();
+  scratch.rewind(start);
+  return range2::make_pair(r, o);
+}
+
+template<typename Rng, typename Rel, typename OutRange>
+ALWAYS_INLINE_HIDDEN auto sliding_extremum(Rng r, RangeDifferenceType<Rng> w, Rel rel, OutRange o, arena& scratch) -> decltype( sliding_extremum_impl(add_constant_time_count(r), w, rel, add_constant_time_count(o), scratch) ) {
+  static_assert(RepeatableRange<Rng>::value, "Candidate iterators are revisited so the range must be multipass");
+  // Precondition w > 0
+  return sliding_extremum_impl(add_constant_time_count(r), w, rel, add_constant_time_count(o), scratch);
+}
+
+template<typename Rng, typename Rel, typename OutRange>
+ALWAYS_INLINE_HIDDEN auto sliding_extremum(Rng r, RangeDifferenceType<Rng> w, Rel rel, OutRange o) -> decltype( sliding_extremum_impl(add_constant_time_count(r), w, rel, add_constant_time_count(o), std::declval<arena&>()) ) {
+  arena scratch;
+  return sliding_extremum(r, w, rel, o, scratch);
+}
+
+} // namespace range2
+
+#endif